@@ -0,0 +1,318 @@
+#include "Hooks/fake_event_parameter.hpp"
+#include "Utils/FlatHashIndex.hpp"
+
+#include <fmod/fmod_studio_common.h>
+#include <fmod/fmod.hpp>
+
+#include <unordered_map>
+#include <string_view>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iterator>
+#include <cstdio>
+#include <cstdint>
+
+//Console benchmarks for the hot paths of the extension. Build the Release configuration and run it without a debugger
+
+using BenchClock = std::chrono::steady_clock;
+
+//Keeps the optimizer from dropping the measured loops
+static volatile std::size_t g_sink = 0;
+
+static void print_usage()
+{
+	std::printf(
+		"Usage:\n"
+		"  CAEBenchmark [registry|params|state]\n"
+	);
+}
+
+template<typename T_Func>
+static double measure_ns_per_op(const std::size_t opCount, T_Func func)
+{
+	const BenchClock::time_point v_start = BenchClock::now();
+	func();
+	const BenchClock::time_point v_end = BenchClock::now();
+
+	return std::chrono::duration<double, std::nano>(v_end - v_start).count() / static_cast<double>(opCount);
+}
+
+//Same size as the sound data the old registry stored in the map
+struct BenchSoundData
+{
+	void* sound;
+	float minDistance;
+	float maxDistance;
+	std::uint32_t pathId;
+	std::uint8_t flags;
+};
+
+//Sound name lookups: the unordered_map the sounds were stored in before against FlatHashIndex with a contiguous array.
+//The names are hashed up front, both registries are keyed by the same name hash
+static void bench_registry()
+{
+	constexpr std::size_t v_probeCount = 2000000;
+
+	std::printf("Sound registry lookups, %zu random probes of registered names:\n", v_probeCount);
+
+	for (const std::size_t v_nameCount : { 1000, 10000, 100000 })
+	{
+		std::vector<std::size_t> v_hashes;
+		v_hashes.reserve(v_nameCount);
+		for (std::size_t a = 0; a < v_nameCount; a++)
+		{
+			const std::string v_name = "ExampleMod_SoundName_" + std::to_string(a * 7919);
+			v_hashes.push_back(std::hash<std::string_view>{}(v_name));
+		}
+
+		std::unordered_map<std::size_t, BenchSoundData> v_map;
+		FlatHashIndex v_index;
+		std::vector<BenchSoundData> v_sounds;
+
+		for (const std::size_t v_hash : v_hashes)
+		{
+			v_map.emplace(v_hash, BenchSoundData{});
+			v_index.insert(v_hash, static_cast<std::uint32_t>(v_sounds.size()));
+			v_sounds.push_back(BenchSoundData{});
+		}
+
+		std::mt19937 v_random(1);
+		std::vector<std::size_t> v_probes;
+		v_probes.reserve(v_probeCount);
+		for (std::size_t a = 0; a < v_probeCount; a++)
+			v_probes.push_back(v_hashes[v_random() % v_nameCount]);
+
+		const double v_mapNs = measure_ns_per_op(v_probeCount, [&]() {
+			std::size_t v_sum = 0;
+			for (const std::size_t v_hash : v_probes)
+				v_sum += reinterpret_cast<std::size_t>(&v_map.find(v_hash)->second);
+
+			g_sink = v_sum;
+		});
+
+		const double v_flatNs = measure_ns_per_op(v_probeCount, [&]() {
+			std::size_t v_sum = 0;
+			for (const std::size_t v_hash : v_probes)
+				v_sum += reinterpret_cast<std::size_t>(&v_sounds[v_index.find(v_hash)]);
+
+			g_sink = v_sum;
+		});
+
+		std::printf("  %6zu names: unordered_map %.1f ns, FlatHashIndex %.1f ns\n", v_nameCount, v_mapNs, v_flatNs);
+	}
+}
+
+//Parameter names as the game passes them to setParameterByName: the unordered_map the names were looked up in before
+//against the switch the hooks use now. The names are handed over as C strings, like in the hooks
+static void bench_parameter_names()
+{
+	constexpr std::size_t v_callCount = 1000000;
+	constexpr std::size_t v_repeatCount = 20;
+
+	static const std::unordered_map<std::string_view, FakeEventParameter> v_oldTable =
+	{
+		{ "DLM_Pitch"    , FakeEventParameter::Pitch     },
+		{ "DLM_Volume"   , FakeEventParameter::Volume    },
+		{ "DLM_Reverb"   , FakeEventParameter::Reverb    },
+		{ "DLM_ReverbIdx", FakeEventParameter::ReverbIdx },
+		{ "CAE_Pitch"    , FakeEventParameter::Pitch     },
+		{ "CAE_Volume"   , FakeEventParameter::Volume    },
+		{ "CAE_Reverb"   , FakeEventParameter::Reverb    },
+		{ "CAE_ReverbIdx", FakeEventParameter::ReverbIdx },
+		{ "CAE_Position" , FakeEventParameter::Position  }
+	};
+
+	const char* v_hitNames[] = { "CAE_Pitch", "CAE_Volume", "CAE_Reverb", "CAE_ReverbIdx", "CAE_Position", "DLM_Pitch", "DLM_Volume" };
+	//Parameters of the vanilla game events, they are passed to the fake instances as well
+	const char* v_missNames[] = { "rpm", "load", "speed", "CAE_Unknown", "intensity" };
+
+	std::mt19937 v_random(1);
+	std::vector<const char*> v_hits, v_misses, v_mixed;
+	for (std::size_t a = 0; a < v_callCount; a++)
+	{
+		v_hits.push_back(v_hitNames[v_random() % std::size(v_hitNames)]);
+		v_misses.push_back(v_missNames[v_random() % std::size(v_missNames)]);
+		v_mixed.push_back((v_random() % 4) ? v_hitNames[v_random() % std::size(v_hitNames)] : v_missNames[v_random() % std::size(v_missNames)]);
+	}
+
+	const auto v_measureOld = [](const std::vector<const char*>& names) -> double {
+		return measure_ns_per_op(names.size() * v_repeatCount, [&names]() {
+			std::size_t v_sum = 0;
+			for (std::size_t a = 0; a < v_repeatCount; a++)
+			{
+				for (const char* v_name : names)
+				{
+					const auto v_iter = v_oldTable.find(std::string_view(v_name));
+					v_sum += (v_iter != v_oldTable.end()) ? std::size_t(v_iter->second) : std::size_t(FakeEventParameter::Count);
+				}
+			}
+
+			g_sink = v_sum;
+		});
+	};
+
+	const auto v_measureNew = [](const std::vector<const char*>& names) -> double {
+		return measure_ns_per_op(names.size() * v_repeatCount, [&names]() {
+			std::size_t v_sum = 0;
+			for (std::size_t a = 0; a < v_repeatCount; a++)
+				for (const char* v_name : names)
+					v_sum += std::size_t(get_fake_event_parameter(v_name));
+
+			g_sink = v_sum;
+		});
+	};
+
+	std::printf("Parameter name matching, %zu calls:\n", v_callCount * v_repeatCount);
+	std::printf("  CAE_/DLM_ names:    unordered_map %.1f ns, switch %.1f ns\n", v_measureOld(v_hits), v_measureNew(v_hits));
+	std::printf("  foreign names:      unordered_map %.1f ns, switch %.1f ns\n", v_measureOld(v_misses), v_measureNew(v_misses));
+	std::printf("  75%% CAE_/DLM_ mix: unordered_map %.1f ns, switch %.1f ns\n", v_measureOld(v_mixed), v_measureNew(v_mixed));
+}
+
+//Cached state the same way FakeEventDescription keeps it, coalesced instances ask the shared voice
+struct BenchFakeInstance
+{
+	BenchFakeInstance* voice;
+	FMOD_STUDIO_PLAYBACK_STATE playbackState;
+
+	FMOD_STUDIO_PLAYBACK_STATE getPlaybackState() const
+	{
+		if (voice)
+			return voice->playbackState;
+
+		return playbackState;
+	}
+};
+
+//Playback state queries at 1000 active instances: Channel::isPlaying on real FMOD channels, which is what
+//the hooks called before, against the cached state the hooks read now. The mixer runs on the no sound output,
+//so the channel calls take the same locks as in the game
+static bool bench_playback_state()
+{
+	constexpr int v_instanceCount = 1000;
+	constexpr std::size_t v_repeatCount = 2000;
+
+	FMOD::System* v_pSystem;
+	if (FMOD::System_Create(&v_pSystem) != FMOD_OK)
+	{
+		std::printf("Failed to create the FMOD system\n");
+		return false;
+	}
+
+	if (v_pSystem->setOutput(FMOD_OUTPUTTYPE_NOSOUND) != FMOD_OK ||
+		v_pSystem->init(v_instanceCount + 24, FMOD_INIT_NORMAL, nullptr) != FMOD_OK)
+	{
+		std::printf("Failed to initialize the FMOD system\n");
+		v_pSystem->release();
+		return false;
+	}
+
+	//One second of silence, created in memory so the benchmark doesn't depend on any file
+	FMOD_CREATESOUNDEXINFO v_exInfo{};
+	v_exInfo.cbsize = sizeof(v_exInfo);
+	v_exInfo.numchannels = 2;
+	v_exInfo.defaultfrequency = 48000;
+	v_exInfo.format = FMOD_SOUND_FORMAT_PCM16;
+	v_exInfo.length = 48000 * 2 * sizeof(std::int16_t);
+
+	FMOD::Sound* v_pSound;
+	if (v_pSystem->createSound(nullptr, FMOD_OPENUSER | FMOD_LOOP_NORMAL | FMOD_CREATESAMPLE, &v_exInfo, &v_pSound) != FMOD_OK)
+	{
+		std::printf("Failed to create the sound\n");
+		v_pSystem->release();
+		return false;
+	}
+
+	std::vector<FMOD::Channel*> v_channels;
+	std::vector<BenchFakeInstance> v_instances(v_instanceCount);
+	v_channels.reserve(v_instanceCount);
+
+	for (int a = 0; a < v_instanceCount; a++)
+	{
+		FMOD::Channel* v_pChannel;
+		if (v_pSystem->playSound(v_pSound, nullptr, false, &v_pChannel) != FMOD_OK)
+			break;
+
+		v_channels.push_back(v_pChannel);
+		v_instances[a].voice = nullptr;
+		v_instances[a].playbackState = FMOD_STUDIO_PLAYBACK_PLAYING;
+	}
+
+	//Every 4th instance is merged into the voice of the previous one
+	for (int a = 4; a < v_instanceCount; a += 4)
+		v_instances[a].voice = &v_instances[a - 1];
+
+	v_pSystem->update();
+
+	const std::size_t v_queryCount = v_channels.size() * v_repeatCount;
+
+	const double v_channelNs = measure_ns_per_op(v_queryCount, [&]() {
+		std::size_t v_sum = 0;
+		for (std::size_t a = 0; a < v_repeatCount; a++)
+		{
+			for (FMOD::Channel* v_pChannel : v_channels)
+			{
+				bool v_isPlaying = false;
+				v_pChannel->isPlaying(&v_isPlaying);
+				v_sum += v_isPlaying;
+			}
+		}
+
+		g_sink = v_sum;
+	});
+
+	const double v_cachedNs = measure_ns_per_op(v_instances.size() * v_repeatCount, [&]() {
+		std::size_t v_sum = 0;
+		for (std::size_t a = 0; a < v_repeatCount; a++)
+			for (const BenchFakeInstance& v_instance : v_instances)
+				v_sum += (v_instance.getPlaybackState() != FMOD_STUDIO_PLAYBACK_STOPPED);
+
+		g_sink = v_sum;
+	});
+
+	std::printf("Playback state queries, %zu active channels, %zu queries:\n", v_channels.size(), v_queryCount);
+	std::printf("  Channel::isPlaying %.1f ns, cached state %.1f ns\n", v_channelNs, v_cachedNs);
+
+	for (FMOD::Channel* v_pChannel : v_channels)
+		v_pChannel->stop();
+
+	v_pSound->release();
+	v_pSystem->release();
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	//Runs every benchmark without arguments
+	const std::string_view v_command = (argc > 1) ? argv[1] : "";
+	bool v_ran = false;
+
+	if (v_command.empty() || v_command == "registry")
+	{
+		bench_registry();
+		v_ran = true;
+	}
+
+	if (v_command.empty() || v_command == "params")
+	{
+		bench_parameter_names();
+		v_ran = true;
+	}
+
+	if (v_command.empty() || v_command == "state")
+	{
+		if (!bench_playback_state())
+			return 1;
+
+		v_ran = true;
+	}
+
+	if (!v_ran)
+	{
+		print_usage();
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,248 @@
+#include "Audio/SoundConfig.hpp"
+#include "Audio/SoundBank.hpp"
+#include "Audio/PcmCache.hpp"
+#include "Utils/Console.hpp"
+#include "Utils/String.hpp"
+#include "Utils/File.hpp"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+namespace fs = std::filesystem;
+
+static void print_usage()
+{
+	std::printf(
+		"Usage:\n"
+		"  CAECacheTool build <cache_dir> <mod_dir> [<mod_dir> ...] [--max-size-mb <size>]\n"
+		"  CAECacheTool validate <cache_dir> [--fix]\n"
+		"  CAECacheTool pack <mod_dir> <output.caebank>\n"
+	);
+}
+
+static bool load_mod_config(const fs::path& modDir, SoundConfigData& r_config)
+{
+	const std::string v_modPath = String::ToUtf8(fs::absolute(modDir).lexically_normal().generic_wstring());
+	if (!SoundConfig::Load(v_modPath, r_config))
+	{
+		std::printf("No valid sound config found in: %s\n", v_modPath.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+//Uses the same config loader as the extension
+static bool collect_mod_sound_paths(const fs::path& modDir, std::vector<std::string>& r_paths)
+{
+	SoundConfigData v_config;
+	if (!load_mod_config(modDir, v_config))
+		return false;
+
+	for (SoundConfigEntry& v_entry : v_config.sounds)
+	{
+		//Only decoded samples are loaded from the cache
+		const SoundLoadMode v_loadMode = v_entry.effectData.loadMode;
+		if (v_loadMode == SoundLoadMode::Stream || v_loadMode == SoundLoadMode::Compressed)
+			continue;
+
+		r_paths.push_back(std::move(v_entry.path));
+	}
+
+	return true;
+}
+
+static int build_cache(const fs::path& cacheDir, const std::vector<fs::path>& modDirs, const std::uint64_t sizeLimit)
+{
+	std::error_code v_ec;
+	fs::create_directories(cacheDir, v_ec);
+
+	std::vector<std::string> v_paths;
+	for (const fs::path& v_modDir : modDirs)
+		collect_mod_sound_paths(v_modDir, v_paths);
+
+	FMOD::System* v_pDecoder = PcmCache::CreateDecoderSystem();
+	if (!v_pDecoder)
+	{
+		std::printf("Couldn't create the FMOD decoder system\n");
+		return 1;
+	}
+
+	std::size_t v_built = 0, v_upToDate = 0, v_failed = 0;
+	for (const std::string& v_path : v_paths)
+	{
+		File::Stamp v_stamp;
+		if (!File::GetStamp(v_path, v_stamp))
+		{
+			std::printf("Missing sound file: %s\n", v_path.c_str());
+			v_failed++;
+			continue;
+		}
+
+		MappedFile v_blob;
+		if (v_blob.open(PcmCache::GetBlobPath(cacheDir, v_path).wstring()))
+		{
+			std::string_view v_sourcePath;
+			const PcmBlobHeader* v_pHeader = PcmCache::ReadHeader(v_blob, v_sourcePath);
+			if (v_pHeader && PcmCache::NormalizePath(v_sourcePath) == PcmCache::NormalizePath(v_path) && PcmCache::IsBlobUpToDate(*v_pHeader, v_path, v_stamp))
+			{
+				v_upToDate++;
+				continue;
+			}
+
+			v_blob.close();
+		}
+
+		if (PcmCache::BuildBlob(v_pDecoder, cacheDir, v_path))
+		{
+			std::printf("Cached: %s\n", v_path.c_str());
+			v_built++;
+		}
+		else
+		{
+			std::printf("Failed: %s\n", v_path.c_str());
+			v_failed++;
+		}
+	}
+
+	v_pDecoder->release();
+	PcmCache::EnforceSizeLimit(cacheDir, sizeLimit);
+
+	std::printf("Built: %zu, Up to date: %zu, Failed: %zu\n", v_built, v_upToDate, v_failed);
+	return v_failed ? 2 : 0;
+}
+
+static int validate_cache(const fs::path& cacheDir, const bool fix)
+{
+	std::size_t v_valid = 0, v_invalid = 0;
+	std::uint64_t v_totalSize = 0;
+
+	std::error_code v_ec;
+	for (const fs::directory_entry& v_entry : fs::directory_iterator(cacheDir, v_ec))
+	{
+		if (v_entry.path().extension() != CAE_PCM_BLOB_EXTENSION)
+			continue;
+
+		bool v_isValid = false;
+		std::string v_reason = "corrupted header";
+		{
+			MappedFile v_blob;
+			std::string_view v_sourceView;
+			const PcmBlobHeader* v_pHeader = v_blob.open(v_entry.path().wstring())
+				? PcmCache::ReadHeader(v_blob, v_sourceView)
+				: nullptr;
+
+			if (v_pHeader)
+			{
+				const std::string v_sourcePath(v_sourceView);
+
+				File::Stamp v_stamp;
+				if (!File::GetStamp(v_sourcePath, v_stamp))
+					v_reason = "missing source " + v_sourcePath;
+				else if (PcmCache::GetBlobPath(cacheDir, v_sourcePath).filename() != v_entry.path().filename())
+					v_reason = "wrong key for " + v_sourcePath;
+				else if (!PcmCache::IsBlobUpToDate(*v_pHeader, v_sourcePath, v_stamp))
+					v_reason = "stale " + v_sourcePath;
+				else
+					v_isValid = true;
+			}
+		}
+
+		if (v_isValid)
+		{
+			v_totalSize += v_entry.file_size(v_ec);
+			v_valid++;
+			continue;
+		}
+
+		v_invalid++;
+		std::printf("Invalid blob %ls: %s\n", v_entry.path().filename().c_str(), v_reason.c_str());
+
+		if (fix)
+			fs::remove(v_entry.path(), v_ec);
+	}
+
+	std::printf("Valid: %zu (%llu MB), Invalid: %zu\n", v_valid,
+		static_cast<unsigned long long>(v_totalSize / (1024 * 1024)), v_invalid);
+
+	return (v_invalid && !fix) ? 2 : 0;
+}
+
+static int pack_bank(const fs::path& modDir, const fs::path& output)
+{
+	SoundConfigData v_config;
+	if (!load_mod_config(modDir, v_config))
+		return 1;
+
+	if (v_config.sounds.empty())
+	{
+		std::printf("The sound config has no sounds to pack\n");
+		return 1;
+	}
+
+	const std::vector<SoundConfigEntry>& v_sources = v_config.sounds;
+	if (!SoundBank::Write(output, v_sources))
+	{
+		std::printf("Couldn't write the sound bank: %ls\n", output.c_str());
+		return 2;
+	}
+
+	std::error_code v_ec;
+	std::printf("Packed %zu sounds into %ls (%llu KB)\n", v_sources.size(), output.c_str(),
+		static_cast<unsigned long long>(fs::file_size(output, v_ec) / 1024));
+
+	return 0;
+}
+
+int wmain(int argc, wchar_t** argv)
+{
+	if (argc < 3)
+	{
+		print_usage();
+		return 1;
+	}
+
+	const std::wstring v_command = argv[1];
+	const fs::path v_cacheDir = argv[2];
+
+	if (v_command == L"pack")
+	{
+		if (argc < 4)
+		{
+			print_usage();
+			return 1;
+		}
+
+		return pack_bank(argv[2], argv[3]);
+	}
+
+	if (v_command == L"build")
+	{
+		std::vector<fs::path> v_modDirs;
+		std::uint64_t v_sizeLimit = 2048ull * 1024ull * 1024ull;
+
+		for (int a = 3; a < argc; a++)
+		{
+			if (std::wstring_view(argv[a]) == L"--max-size-mb" && a + 1 < argc)
+				v_sizeLimit = std::wcstoull(argv[++a], nullptr, 10) * 1024ull * 1024ull;
+			else
+				v_modDirs.emplace_back(argv[a]);
+		}
+
+		if (v_modDirs.empty())
+		{
+			print_usage();
+			return 1;
+		}
+
+		return build_cache(v_cacheDir, v_modDirs, v_sizeLimit);
+	}
+
+	if (v_command == L"validate")
+		return validate_cache(v_cacheDir, argc > 3 && std::wstring_view(argv[3]) == L"--fix");
+
+	print_usage();
+	return 1;
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "AudioSettings.hpp"
+
+#include "Utils/Console.hpp"
+#include "Utils/String.hpp"
+#include "Utils/Json.hpp"
+
+#include <filesystem>
+
+static void load_pcm_cache_settings(const simdjson::dom::element& root, const std::wstring& directory)
+{
+	const auto v_pcmCache = root["pcmCache"];
+	if (!v_pcmCache.is_object()) return;
+
+	const auto v_cacheDir = v_pcmCache["directory"];
+	if (!v_cacheDir.is_string())
+	{
+		DebugErrorL("pcmCache.directory must be a string");
+		return;
+	}
+
+	std::filesystem::path v_cachePath(String::ToWide(v_cacheDir.get_string().value_unsafe()));
+	if (v_cachePath.is_relative())
+		v_cachePath = std::filesystem::path(directory) / v_cachePath;
+
+	AudioSettings::PcmCacheDirectory = v_cachePath.lexically_normal().wstring();
+
+	const auto v_maxSize = v_pcmCache["maxSizeMb"];
+	if (v_maxSize.is_number())
+		AudioSettings::PcmCacheSizeLimit = JsonReader::GetNumber<std::uint64_t>(v_maxSize) * 1024ull * 1024ull;
+}
+
+void AudioSettings::Load(const std::wstring& directory)
+{
+	const std::wstring v_settingsPath = directory + L"/CustomAudioExtension.json";
+	std::error_code v_ec;
+	if (!std::filesystem::exists(v_settingsPath, v_ec))
+		return;
+
+	simdjson::dom::document v_document;
+	if (!JsonReader::LoadParseSimdjsonCommentsC(v_settingsPath, v_document, simdjson::dom::element_type::OBJECT))
+	{
+		DebugErrorL("Couldn't load the CAE settings file: ", v_settingsPath);
+		return;
+	}
+
+	const simdjson::dom::element v_root = v_document.root();
+
+	const auto v_lazyLoading = v_root["lazyLoading"];
+	if (v_lazyLoading.is_bool())
+		AudioSettings::LazyLoading = v_lazyLoading.get_bool().value_unsafe();
+
+	const auto v_streamThreshold = v_root["streamSizeThresholdKb"];
+	if (v_streamThreshold.is_number())
+		AudioSettings::StreamSizeThreshold = JsonReader::GetNumber<std::uint64_t>(v_streamThreshold) * 1024ull;
+
+	const auto v_memoryBudget = v_root["memoryBudgetMb"];
+	if (v_memoryBudget.is_number())
+		AudioSettings::MemoryBudget = JsonReader::GetNumber<std::uint64_t>(v_memoryBudget) * 1024ull * 1024ull;
+
+	const auto v_busMetering = v_root["busMetering"];
+	if (v_busMetering.is_bool())
+		AudioSettings::BusMetering = v_busMetering.get_bool().value_unsafe();
+
+	const auto v_leakReport = v_root["leakReportSeconds"];
+	if (v_leakReport.is_number())
+		AudioSettings::LeakReportSeconds = JsonReader::GetNumber<std::uint32_t>(v_leakReport);
+
+	load_pcm_cache_settings(v_root, directory);
+
+	DebugOutL("Loaded the CAE settings file");
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+
+#include <cstdint>
+
+//Extension wide settings, loaded from CustomAudioExtension.json next to the dll
+class AudioSettings
+{
+public:
+	static void Load(const std::wstring& directory);
+
+	//Sounds are loaded on the first lookup instead of when the shapesets are loaded
+	inline static bool LazyLoading = false;
+
+	//Sounds with SoundLoadMode::Auto are streamed if the file is at least this big, 0 disables streaming
+	inline static std::uint64_t StreamSizeThreshold = 2048ull * 1024ull;
+
+	//Upper limit for the memory used by loaded sounds, 0 means unlimited
+	inline static std::uint64_t MemoryBudget = 0;
+
+	//Empty if the decoded PCM cache is disabled
+	inline static std::wstring PcmCacheDirectory;
+	inline static std::uint64_t PcmCacheSizeLimit = 2048ull * 1024ull * 1024ull;
+
+	//Periodically logs the peak and RMS level of every CAE bus
+	inline static bool BusMetering = false;
+
+	//Fake event instances that are still not released this long after their creation are logged, 0 disables the report
+	inline static std::uint32_t LeakReportSeconds = 300;
+
+private:
+	AudioSettings() = default;
+	AudioSettings(const AudioSettings&) = delete;
+	AudioSettings(AudioSettings&&) = delete;
+	~AudioSettings() = default;
+};
\ No newline at end of file
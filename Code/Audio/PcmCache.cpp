@@ -0,0 +1,427 @@
+#include "PcmCache.hpp"
+
+#include "Utils/Console.hpp"
+#include "Utils/String.hpp"
+#include "Utils/Hash.hpp"
+
+#include <unordered_set>
+#include <algorithm>
+#include <fstream>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <cwctype>
+
+namespace fs = std::filesystem;
+
+static std::mutex g_pcmCacheMutex;
+static std::deque<std::string> g_pcmCacheQueue;
+static std::unordered_set<std::string> g_pcmCacheQueued;
+static bool g_pcmCacheWorkerStarted = false;
+
+static bool is_pcm_format(const FMOD_SOUND_FORMAT format)
+{
+	switch (format)
+	{
+	case FMOD_SOUND_FORMAT_PCM8:
+	case FMOD_SOUND_FORMAT_PCM16:
+	case FMOD_SOUND_FORMAT_PCM24:
+	case FMOD_SOUND_FORMAT_PCM32:
+	case FMOD_SOUND_FORMAT_PCMFLOAT:
+		return true;
+	default:
+		return false;
+	}
+}
+
+//Writes the new source stamp into an existing blob after the content hash has confirmed it is still valid.
+//Only the header changes, so a retired sound that still maps the blob keeps playing the same samples
+static void restamp_blob(const fs::path& blobPath, const File::Stamp& stamp)
+{
+	std::fstream v_blobFile(blobPath, std::ios::binary | std::ios::in | std::ios::out);
+	if (!v_blobFile.is_open()) return;
+
+	const std::uint64_t v_sourceSize = static_cast<std::uint64_t>(stamp.size);
+	v_blobFile.seekp(offsetof(PcmBlobHeader, sourceSize));
+	v_blobFile.write(reinterpret_cast<const char*>(&v_sourceSize), sizeof(v_sourceSize));
+	v_blobFile.write(reinterpret_cast<const char*>(&stamp.writeTime), sizeof(stamp.writeTime));
+}
+
+void PcmCache::Initialize(const std::wstring& directory, const std::uint64_t sizeLimit)
+{
+	std::error_code v_ec;
+	fs::create_directories(directory, v_ec);
+	if (v_ec)
+	{
+		DebugErrorL("Couldn't create the PCM cache directory: ", directory);
+		return;
+	}
+
+	PcmCache::Directory = directory;
+	PcmCache::SizeLimit = sizeLimit;
+
+	DebugOutL("PCM cache enabled: ", directory);
+}
+
+bool PcmCache::IsEnabled() noexcept
+{
+	return !PcmCache::Directory.empty();
+}
+
+FMOD::Sound* PcmCache::CreateSound(
+	FMOD::System* system,
+	const std::string& path,
+	const File::Stamp& stamp,
+	MappedFile& r_mapping)
+{
+	const fs::path v_blobPath = PcmCache::GetBlobPath(PcmCache::Directory, path);
+	if (!r_mapping.open(v_blobPath.wstring()))
+		return nullptr;
+
+	std::string_view v_sourcePath;
+	const PcmBlobHeader* v_pHeader = PcmCache::ReadHeader(r_mapping, v_sourcePath);
+	if (!v_pHeader || PcmCache::NormalizePath(v_sourcePath) != PcmCache::NormalizePath(path))
+	{
+		r_mapping.close();
+		return nullptr;
+	}
+
+	//Hashing the source here would block the game thread, the cache worker compares the contents instead
+	if (v_pHeader->sourceSize != stamp.size || v_pHeader->sourceWriteTime != stamp.writeTime)
+	{
+		r_mapping.close();
+		return nullptr;
+	}
+
+	FMOD_CREATESOUNDEXINFO v_exInfo = {};
+	v_exInfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+	v_exInfo.length = static_cast<unsigned int>(v_pHeader->dataLength);
+	v_exInfo.numchannels = v_pHeader->channels;
+	v_exInfo.defaultfrequency = static_cast<int>(v_pHeader->frequency);
+	v_exInfo.format = static_cast<FMOD_SOUND_FORMAT>(v_pHeader->format);
+
+	FMOD::Sound* v_pSound;
+	if (system->createSound(
+		reinterpret_cast<const char*>(r_mapping.data() + v_pHeader->dataOffset),
+		FMOD_OPENMEMORY_POINT | FMOD_OPENRAW | FMOD_CREATESAMPLE,
+		&v_exInfo,
+		&v_pSound) != FMOD_OK)
+	{
+		r_mapping.close();
+		return nullptr;
+	}
+
+	//The write time of the blob is used as the last access time for eviction
+	std::error_code v_ec;
+	fs::last_write_time(v_blobPath, fs::file_time_type::clock::now(), v_ec);
+
+	return v_pSound;
+}
+
+void PcmCache::QueueBuild(const std::string& path)
+{
+	{
+		std::lock_guard v_lock(g_pcmCacheMutex);
+		if (!g_pcmCacheQueued.insert(path).second)
+			return;
+
+		g_pcmCacheQueue.push_back(path);
+
+		if (g_pcmCacheWorkerStarted)
+			return;
+
+		//The worker holds a reference to the dll until it exits, so the dll can't be unloaded under it
+		HMODULE v_hModule;
+		if (!GetModuleHandleExW(
+			GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
+			reinterpret_cast<LPCWSTR>(&PcmCache::WorkerThread),
+			&v_hModule))
+		{
+			return;
+		}
+
+		const HANDLE v_hThread = CreateThread(NULL, 0, PcmCache::WorkerThread, v_hModule, 0, NULL);
+		if (!v_hThread)
+		{
+			FreeLibrary(v_hModule);
+			return;
+		}
+
+		CloseHandle(v_hThread);
+		g_pcmCacheWorkerStarted = true;
+	}
+}
+
+FMOD::System* PcmCache::CreateDecoderSystem()
+{
+	FMOD::System* v_pSystem;
+	if (FMOD::System_Create(&v_pSystem) != FMOD_OK)
+		return nullptr;
+
+	//Non realtime output without a device, only used to decode sounds
+	if (v_pSystem->setOutput(FMOD_OUTPUTTYPE_NOSOUND_NRT) != FMOD_OK ||
+		v_pSystem->init(1, FMOD_INIT_NORMAL, nullptr) != FMOD_OK)
+	{
+		v_pSystem->release();
+		return nullptr;
+	}
+
+	return v_pSystem;
+}
+
+std::wstring PcmCache::NormalizePath(const std::string_view& path)
+{
+	//The cache tool and the game can spell the same path differently
+	std::error_code v_ec;
+	std::wstring v_key = fs::absolute(String::ToWide(path), v_ec).lexically_normal().make_preferred().wstring();
+	std::transform(v_key.begin(), v_key.end(), v_key.begin(), [](wchar_t c) { return std::towlower(c); });
+
+	return v_key;
+}
+
+fs::path PcmCache::GetBlobPath(const fs::path& directory, const std::string& path)
+{
+	const std::wstring v_key = PcmCache::NormalizePath(path);
+	const std::uint64_t v_keyHash = Hash::Data(v_key.data(), v_key.size() * sizeof(wchar_t));
+
+	wchar_t v_fileName[17];
+	swprintf(v_fileName, 17, L"%016llx", static_cast<unsigned long long>(v_keyHash));
+
+	return directory / (std::wstring(v_fileName) + CAE_PCM_BLOB_EXTENSION);
+}
+
+const PcmBlobHeader* PcmCache::ReadHeader(const MappedFile& blob, std::string_view& r_sourcePath)
+{
+	if (blob.size() < sizeof(PcmBlobHeader))
+		return nullptr;
+
+	const PcmBlobHeader* v_pHeader = reinterpret_cast<const PcmBlobHeader*>(blob.data());
+	if (v_pHeader->magic != CAE_PCM_BLOB_MAGIC || v_pHeader->version != CAE_PCM_BLOB_VERSION)
+		return nullptr;
+
+	if (sizeof(PcmBlobHeader) + v_pHeader->pathLength > v_pHeader->dataOffset ||
+		v_pHeader->dataOffset + v_pHeader->dataLength > blob.size())
+		return nullptr;
+
+	r_sourcePath = std::string_view(
+		reinterpret_cast<const char*>(blob.data() + sizeof(PcmBlobHeader)),
+		v_pHeader->pathLength
+	);
+
+	return v_pHeader;
+}
+
+bool PcmCache::IsBlobUpToDate(const PcmBlobHeader& header, const std::string& sourcePath, const File::Stamp& stamp)
+{
+	if (header.sourceSize == stamp.size && header.sourceWriteTime == stamp.writeTime)
+		return true;
+
+	//The file might have been touched or copied without changing, compare the contents
+	if (header.sourceSize != stamp.size)
+		return false;
+
+	std::uint64_t v_contentHash;
+	if (!Hash::File(String::ToWide(sourcePath), v_contentHash))
+		return false;
+
+	return v_contentHash == header.contentHash;
+}
+
+bool PcmCache::BuildBlob(FMOD::System* decoder, const fs::path& directory, const std::string& path)
+{
+	File::Stamp v_stamp;
+	std::uint64_t v_contentHash;
+	if (!File::GetStamp(path, v_stamp) || !Hash::File(String::ToWide(path), v_contentHash))
+		return false;
+
+	const fs::path v_blobPath = PcmCache::GetBlobPath(directory, path);
+
+	//The file might have been touched or copied without changing, the blob only needs the new stamp then
+	{
+		MappedFile v_blob;
+		std::string_view v_sourcePath;
+		const PcmBlobHeader* v_pHeader = v_blob.open(v_blobPath.wstring()) ? PcmCache::ReadHeader(v_blob, v_sourcePath) : nullptr;
+		if (v_pHeader &&
+			v_pHeader->sourceSize == static_cast<std::uint64_t>(v_stamp.size) &&
+			v_pHeader->contentHash == v_contentHash &&
+			PcmCache::NormalizePath(v_sourcePath) == PcmCache::NormalizePath(path))
+		{
+			v_blob.close();
+			restamp_blob(v_blobPath, v_stamp);
+			return true;
+		}
+	}
+
+	FMOD::Sound* v_pSound;
+	if (decoder->createSound(path.c_str(), FMOD_CREATESAMPLE | FMOD_ACCURATETIME, nullptr, &v_pSound) != FMOD_OK)
+	{
+		DebugErrorL("Couldn't decode the sound: ", path);
+		return false;
+	}
+
+	FMOD_SOUND_FORMAT v_format;
+	int v_channels;
+	float v_frequency;
+	unsigned int v_dataLength;
+
+	if (v_pSound->getFormat(nullptr, &v_format, &v_channels, nullptr) != FMOD_OK ||
+		v_pSound->getDefaults(&v_frequency, nullptr) != FMOD_OK ||
+		v_pSound->getLength(&v_dataLength, FMOD_TIMEUNIT_PCMBYTES) != FMOD_OK ||
+		!is_pcm_format(v_format))
+	{
+		v_pSound->release();
+		return false;
+	}
+
+	void* v_pData1;
+	void* v_pData2;
+	unsigned int v_length1, v_length2;
+	if (v_pSound->lock(0, v_dataLength, &v_pData1, &v_pData2, &v_length1, &v_length2) != FMOD_OK)
+	{
+		v_pSound->release();
+		return false;
+	}
+
+	const std::uint64_t v_dataOffset = (sizeof(PcmBlobHeader) + path.size() + CAE_PCM_BLOB_DATA_ALIGNMENT - 1)
+		& ~std::uint64_t(CAE_PCM_BLOB_DATA_ALIGNMENT - 1);
+
+	const PcmBlobHeader v_header = {
+		.magic = CAE_PCM_BLOB_MAGIC,
+		.version = CAE_PCM_BLOB_VERSION,
+		.sourceSize = static_cast<std::uint64_t>(v_stamp.size),
+		.sourceWriteTime = v_stamp.writeTime,
+		.contentHash = v_contentHash,
+		.dataOffset = v_dataOffset,
+		.dataLength = std::uint64_t(v_length1) + v_length2,
+		.format = static_cast<std::int32_t>(v_format),
+		.channels = v_channels,
+		.frequency = v_frequency,
+		.pathLength = static_cast<std::uint32_t>(path.size())
+	};
+
+	//Write into a temporary file first, so a half written blob is never picked up by the game
+	fs::path v_tempPath = v_blobPath;
+	v_tempPath += L".tmp";
+
+	bool v_success;
+	{
+		std::ofstream v_blobFile(v_tempPath, std::ios::binary | std::ios::trunc);
+
+		const std::string v_padding(v_dataOffset - sizeof(PcmBlobHeader) - path.size(), '\0');
+		v_blobFile.write(reinterpret_cast<const char*>(&v_header), sizeof(v_header));
+		v_blobFile.write(path.data(), path.size());
+		v_blobFile.write(v_padding.data(), v_padding.size());
+		v_blobFile.write(static_cast<const char*>(v_pData1), v_length1);
+		if (v_pData2) v_blobFile.write(static_cast<const char*>(v_pData2), v_length2);
+
+		v_success = v_blobFile.good();
+	}
+
+	v_pSound->unlock(v_pData1, v_pData2, v_length1, v_length2);
+	v_pSound->release();
+
+	std::error_code v_ec;
+	if (!v_success)
+	{
+		fs::remove(v_tempPath, v_ec);
+		return false;
+	}
+
+	//Fails while a retired sound still maps the old blob, the sound is cached again on its next cache miss
+	fs::rename(v_tempPath, v_blobPath, v_ec);
+	if (v_ec)
+	{
+		DebugWarningL("Couldn't replace the cached sound, the old blob is still in use: ", path);
+		fs::remove(v_tempPath, v_ec);
+		return false;
+	}
+
+	return true;
+}
+
+void PcmCache::EnforceSizeLimit(const fs::path& directory, const std::uint64_t sizeLimit)
+{
+	struct BlobInfo
+	{
+		fs::path path;
+		std::uint64_t size;
+		fs::file_time_type lastAccess;
+	};
+
+	std::vector<BlobInfo> v_blobs;
+	std::uint64_t v_totalSize = 0;
+
+	std::error_code v_ec;
+	for (const fs::directory_entry& v_entry : fs::directory_iterator(directory, v_ec))
+	{
+		if (v_entry.path().extension() != CAE_PCM_BLOB_EXTENSION)
+			continue;
+
+		const std::uint64_t v_size = v_entry.file_size(v_ec);
+		if (v_ec) continue;
+
+		v_blobs.push_back(BlobInfo{ v_entry.path(), v_size, v_entry.last_write_time(v_ec) });
+		v_totalSize += v_size;
+	}
+
+	if (v_totalSize <= sizeLimit)
+		return;
+
+	std::sort(v_blobs.begin(), v_blobs.end(),
+		[](const BlobInfo& a, const BlobInfo& b) { return a.lastAccess < b.lastAccess; });
+
+	for (const BlobInfo& v_blob : v_blobs)
+	{
+		if (v_totalSize <= sizeLimit)
+			break;
+
+		//Blobs that are currently mapped might fail to be removed, skip them
+		if (fs::remove(v_blob.path, v_ec))
+			v_totalSize -= v_blob.size;
+	}
+}
+
+DWORD WINAPI PcmCache::WorkerThread(LPVOID module)
+{
+	FMOD::System* v_pDecoder = PcmCache::CreateDecoderSystem();
+	if (!v_pDecoder)
+		DebugErrorL("Couldn't create the PCM cache decoder system");
+
+	//Exits once the queue is empty, the next PcmCache::QueueBuild call starts a new worker
+	while (true)
+	{
+		std::string v_path;
+		{
+			std::lock_guard v_lock(g_pcmCacheMutex);
+			if (!v_pDecoder || g_pcmCacheQueue.empty())
+			{
+				g_pcmCacheQueue.clear();
+				g_pcmCacheQueued.clear();
+				g_pcmCacheWorkerStarted = false;
+				break;
+			}
+
+			v_path = std::move(g_pcmCacheQueue.front());
+			g_pcmCacheQueue.pop_front();
+		}
+
+		if (PcmCache::BuildBlob(v_pDecoder, PcmCache::Directory, v_path))
+			DebugOutL(__FUNCTION__, " -> Cached a sound: ", v_path);
+
+		bool v_queueEmpty;
+		{
+			std::lock_guard v_lock(g_pcmCacheMutex);
+			g_pcmCacheQueued.erase(v_path);
+			v_queueEmpty = g_pcmCacheQueue.empty();
+		}
+
+		if (v_queueEmpty)
+			PcmCache::EnforceSizeLimit(PcmCache::Directory, PcmCache::SizeLimit);
+	}
+
+	if (v_pDecoder)
+		v_pDecoder->release();
+
+	//Drops the reference taken by PcmCache::QueueBuild, an unload that was waiting for the worker happens here
+	FreeLibraryAndExitThread(static_cast<HMODULE>(module), 0);
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Utils/MappedFile.hpp"
+#include "Utils/File.hpp"
+
+#include <fmod/fmod.hpp>
+
+#include <filesystem>
+#include <string_view>
+#include <string>
+
+#include <cstdint>
+
+#define CAE_PCM_BLOB_MAGIC 0x50454143 //CAEP
+#define CAE_PCM_BLOB_VERSION 1
+#define CAE_PCM_BLOB_EXTENSION L".caepcm"
+#define CAE_PCM_BLOB_DATA_ALIGNMENT 4096
+
+//Blob layout: header, source path (utf8), padding up to dataOffset, raw PCM data
+struct PcmBlobHeader
+{
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::uint64_t sourceSize;
+	std::int64_t sourceWriteTime;
+	std::uint64_t contentHash;
+	std::uint64_t dataOffset;
+	std::uint64_t dataLength;
+	std::int32_t format;
+	std::int32_t channels;
+	float frequency;
+	std::uint32_t pathLength;
+};
+
+//Persistent cache of decoded sounds. Cache hits are memory mapped and handed to FMOD
+//with FMOD_OPENMEMORY_POINT | FMOD_OPENRAW, so nothing is decoded or copied
+class PcmCache
+{
+public:
+	static void Initialize(const std::wstring& directory, const std::uint64_t sizeLimit);
+	static bool IsEnabled() noexcept;
+
+	//Returns nullptr on a cache miss. The mapping has to outlive the returned sound
+	static FMOD::Sound* CreateSound(
+		FMOD::System* system,
+		const std::string& path,
+		const File::Stamp& stamp,
+		MappedFile& r_mapping
+	);
+
+	//Decodes the sound into the cache on a background thread. Blobs with an outdated stamp are
+	//only restamped if the contents of the source haven't changed
+	static void QueueBuild(const std::string& path);
+
+	//Functions shared with the offline cache tool
+
+	static FMOD::System* CreateDecoderSystem();
+	static std::wstring NormalizePath(const std::string_view& path);
+	static std::filesystem::path GetBlobPath(const std::filesystem::path& directory, const std::string& path);
+	static const PcmBlobHeader* ReadHeader(const MappedFile& blob, std::string_view& r_sourcePath);
+	//Hashes the source if only the write time differs, too slow for the game thread
+	static bool IsBlobUpToDate(const PcmBlobHeader& header, const std::string& sourcePath, const File::Stamp& stamp);
+	static bool BuildBlob(FMOD::System* decoder, const std::filesystem::path& directory, const std::string& path);
+	static void EnforceSizeLimit(const std::filesystem::path& directory, const std::uint64_t sizeLimit);
+
+private:
+	static DWORD WINAPI WorkerThread(LPVOID module);
+
+	inline static std::filesystem::path Directory;
+	inline static std::uint64_t SizeLimit = 0;
+
+	PcmCache() = default;
+	PcmCache(const PcmCache&) = delete;
+	PcmCache(PcmCache&&) = delete;
+	~PcmCache() = default;
+};
\ No newline at end of file
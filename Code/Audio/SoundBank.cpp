@@ -0,0 +1,237 @@
+#include "SoundBank.hpp"
+
+#include "Utils/Console.hpp"
+#include "Utils/String.hpp"
+#include "Utils/Hash.hpp"
+
+#include <unordered_map>
+#include <iterator>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+static std::uint64_t align_offset(const std::uint64_t offset) noexcept
+{
+	return (offset + CAE_BANK_DATA_ALIGNMENT - 1) & ~std::uint64_t(CAE_BANK_DATA_ALIGNMENT - 1);
+}
+
+bool SoundBank::open(const std::string& path)
+{
+	m_pHeader = nullptr;
+	m_pEntries = nullptr;
+	m_pNames = nullptr;
+
+	if (!File::GetStamp(path, m_stamp) || !m_mapping.open(String::ToWide(path)))
+		return false;
+
+	m_path = path;
+
+	const std::uint8_t* v_pData = m_mapping.data();
+	const std::uint64_t v_size = m_mapping.size();
+	if (v_size < sizeof(SoundBankHeader))
+		return false;
+
+	const SoundBankHeader* v_pHeader = reinterpret_cast<const SoundBankHeader*>(v_pData);
+	if (v_pHeader->magic != CAE_BANK_MAGIC || v_pHeader->version != CAE_BANK_VERSION)
+	{
+		DebugErrorL("Unsupported sound bank version, repack it with CAECacheTool: ", path);
+		return false;
+	}
+
+	const std::uint64_t v_entriesSize = std::uint64_t(v_pHeader->soundCount) * sizeof(SoundBankEntry);
+	if (v_pHeader->entriesOffset + v_entriesSize > v_size || v_pHeader->namesOffset + v_pHeader->namesSize > v_size)
+		return false;
+
+	const SoundBankEntry* v_pEntries = reinterpret_cast<const SoundBankEntry*>(v_pData + v_pHeader->entriesOffset);
+	for (std::uint32_t a = 0; a < v_pHeader->soundCount; a++)
+	{
+		const SoundBankEntry& v_entry = v_pEntries[a];
+		if (std::uint64_t(v_entry.nameOffset) + v_entry.nameLength > v_pHeader->namesSize ||
+			v_entry.dataOffset + v_entry.dataLength > v_size)
+		{
+			DebugErrorL("Corrupted sound bank entry in: ", path);
+			return false;
+		}
+	}
+
+	m_pHeader = v_pHeader;
+	m_pEntries = v_pEntries;
+	m_pNames = reinterpret_cast<const char*>(v_pData + v_pHeader->namesOffset);
+
+	return true;
+}
+
+std::string_view SoundBank::name(const SoundBankEntry& entry) const noexcept
+{
+	return std::string_view(m_pNames + entry.nameOffset, entry.nameLength);
+}
+
+const std::uint8_t* SoundBank::data(const SoundBankEntry& entry) const noexcept
+{
+	return m_mapping.data() + entry.dataOffset;
+}
+
+SoundEffectData SoundBank::effectData(const SoundBankEntry& entry) const noexcept
+{
+	return SoundEffectData{
+		.loadMode = static_cast<SoundLoadMode>(entry.loadMode),
+		.is3D = entry.is3D != 0,
+		.reverbIdx = entry.reverbIdx,
+		.fMinDistance = entry.minDistance,
+		.fMaxDistance = entry.maxDistance,
+		.maxInstances = entry.maxInstances,
+		.stealMode = static_cast<SoundStealMode>(entry.stealMode),
+		.coalesceWindowMs = entry.coalesceWindowMs,
+		.coalesceVolume = static_cast<SoundCoalesceVolume>(entry.coalesceVolume),
+		.coalescePosition = static_cast<SoundCoalescePosition>(entry.coalescePosition),
+		.fadeInMs = entry.fadeInMs,
+		.fadeOutMs = entry.fadeOutMs,
+		.sequenceIntervalMs = entry.sequenceIntervalMs,
+		.sequenceOffsetMs = entry.sequenceOffsetMs,
+		.loopCount = entry.loopCount,
+		.loopUnit = static_cast<SoundLoopUnit>(entry.loopUnit),
+		.loopStart = entry.loopStart,
+		.loopEnd = entry.loopEnd
+	};
+}
+
+std::uint64_t SoundBank::HashName(const std::string_view& name) noexcept
+{
+	return Hash::Data(name.data(), name.size());
+}
+
+bool SoundBank::Write(const fs::path& output, const std::vector<SoundConfigEntry>& sounds)
+{
+	std::vector<SoundBankEntry> v_entries;
+	std::vector<std::vector<char>> v_payloads;
+	std::unordered_map<std::uint64_t, std::size_t> v_payloadIndex;
+	std::vector<std::size_t> v_entryPayload;
+	std::string v_names;
+
+	for (const SoundConfigEntry& v_source : sounds)
+	{
+		std::ifstream v_input(String::ToWide(v_source.path), std::ios::binary);
+		if (!v_input.is_open())
+		{
+			DebugErrorL("Couldn't open the sound file: ", v_source.path);
+			return false;
+		}
+
+		std::vector<char> v_payload((std::istreambuf_iterator<char>(v_input)), std::istreambuf_iterator<char>());
+		const std::uint64_t v_contentHash = Hash::Data(v_payload.data(), v_payload.size());
+
+		auto v_iter = v_payloadIndex.find(v_contentHash);
+		if (v_iter == v_payloadIndex.end())
+		{
+			v_iter = v_payloadIndex.emplace(v_contentHash, v_payloads.size()).first;
+			v_payloads.push_back(std::move(v_payload));
+		}
+
+		const SoundEffectData& v_effect = v_source.effectData;
+		v_entries.push_back(SoundBankEntry{
+			.nameHash = SoundBank::HashName(v_source.name),
+			.contentHash = v_contentHash,
+			.dataOffset = 0,
+			.dataLength = v_payloads[v_iter->second].size(),
+			.nameOffset = static_cast<std::uint32_t>(v_names.size()),
+			.nameLength = static_cast<std::uint32_t>(v_source.name.size()),
+			.minDistance = v_effect.fMinDistance,
+			.maxDistance = v_effect.fMaxDistance,
+			.reverbIdx = static_cast<std::int8_t>(v_effect.reverbIdx),
+			.is3D = v_effect.is3D,
+			.loadMode = static_cast<std::uint8_t>(v_effect.loadMode),
+			.loadPolicy = static_cast<std::uint8_t>(v_source.loadPolicy),
+			.maxInstances = v_effect.maxInstances,
+			.stealMode = static_cast<std::uint8_t>(v_effect.stealMode),
+			.reserved = 0,
+			.coalesceWindowMs = v_effect.coalesceWindowMs,
+			.coalesceVolume = static_cast<std::uint8_t>(v_effect.coalesceVolume),
+			.coalescePosition = static_cast<std::uint8_t>(v_effect.coalescePosition),
+			.fadeInMs = v_effect.fadeInMs,
+			.fadeOutMs = v_effect.fadeOutMs,
+			.sequenceIntervalMs = v_effect.sequenceIntervalMs,
+			.sequenceOffsetMs = v_effect.sequenceOffsetMs,
+			.loopCount = v_effect.loopCount,
+			.loopUnit = static_cast<std::uint8_t>(v_effect.loopUnit),
+			.reserved2 = 0,
+			.loopStart = v_effect.loopStart,
+			.loopEnd = v_effect.loopEnd
+		});
+		v_entryPayload.push_back(v_iter->second);
+
+		v_names.append(v_source.name);
+	}
+
+	//Lay out the payloads after the index
+	const std::uint64_t v_entriesOffset = sizeof(SoundBankHeader);
+	const std::uint64_t v_namesOffset = v_entriesOffset + v_entries.size() * sizeof(SoundBankEntry);
+	const std::uint64_t v_dataOffset = align_offset(v_namesOffset + v_names.size());
+
+	std::vector<std::uint64_t> v_payloadOffsets;
+	std::uint64_t v_offset = v_dataOffset;
+	for (const std::vector<char>& v_payload : v_payloads)
+	{
+		v_payloadOffsets.push_back(v_offset);
+		v_offset = align_offset(v_offset + v_payload.size());
+	}
+
+	for (std::size_t a = 0; a < v_entries.size(); a++)
+		v_entries[a].dataOffset = v_payloadOffsets[v_entryPayload[a]];
+
+	const SoundBankHeader v_header{
+		.magic = CAE_BANK_MAGIC,
+		.version = CAE_BANK_VERSION,
+		.soundCount = static_cast<std::uint32_t>(v_entries.size()),
+		.reserved = 0,
+		.entriesOffset = v_entriesOffset,
+		.namesOffset = v_namesOffset,
+		.namesSize = v_names.size(),
+		.dataOffset = v_dataOffset
+	};
+
+	//The bank is replaced in one go, so a failed write never leaves a half written bank behind
+	fs::path v_tempPath = output;
+	v_tempPath += L".tmp";
+
+	bool v_success;
+	{
+		std::ofstream v_output(v_tempPath, std::ios::binary | std::ios::trunc);
+
+		const auto v_writePadding = [&v_output](const std::uint64_t count) {
+			static const char v_zeros[CAE_BANK_DATA_ALIGNMENT] = {};
+			v_output.write(v_zeros, static_cast<std::streamsize>(count));
+		};
+
+		v_output.write(reinterpret_cast<const char*>(&v_header), sizeof(v_header));
+		v_output.write(reinterpret_cast<const char*>(v_entries.data()), v_entries.size() * sizeof(SoundBankEntry));
+		v_output.write(v_names.data(), v_names.size());
+		v_writePadding(v_dataOffset - (v_namesOffset + v_names.size()));
+
+		for (std::size_t a = 0; a < v_payloads.size(); a++)
+		{
+			const std::vector<char>& v_payload = v_payloads[a];
+			v_output.write(v_payload.data(), v_payload.size());
+			v_writePadding(align_offset(v_payloadOffsets[a] + v_payload.size()) - (v_payloadOffsets[a] + v_payload.size()));
+		}
+
+		v_success = v_output.good();
+	}
+
+	std::error_code v_ec;
+	if (!v_success)
+	{
+		fs::remove(v_tempPath, v_ec);
+		return false;
+	}
+
+	//Fails while the game has the old bank mapped
+	fs::rename(v_tempPath, output, v_ec);
+	if (v_ec)
+	{
+		DebugErrorL("Couldn't replace the sound bank, close the game first: ", output.wstring());
+		fs::remove(v_tempPath, v_ec);
+		return false;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "SoundConfig.hpp"
+
+#include "Utils/MappedFile.hpp"
+#include "Utils/File.hpp"
+
+#include <filesystem>
+#include <string_view>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#define CAE_BANK_MAGIC 0x4B424143 //CABK
+#define CAE_BANK_VERSION 4
+#define CAE_BANK_DATA_ALIGNMENT 64
+
+//Bank layout: header, entries in config order, sound names (utf8), aligned audio payloads.
+//Payloads are stored exactly as the source files, identical files are stored once
+struct SoundBankHeader
+{
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::uint32_t soundCount;
+	std::uint32_t reserved;
+	std::uint64_t entriesOffset;
+	std::uint64_t namesOffset;
+	std::uint64_t namesSize;
+	std::uint64_t dataOffset;
+};
+
+struct SoundBankEntry
+{
+	//XXH64 of the sound name
+	std::uint64_t nameHash;
+	//XXH64 of the payload, matches Hash::File of the source file
+	std::uint64_t contentHash;
+	std::uint64_t dataOffset;
+	std::uint64_t dataLength;
+	std::uint32_t nameOffset;
+	std::uint32_t nameLength;
+	float minDistance;
+	float maxDistance;
+	std::int8_t reverbIdx;
+	std::uint8_t is3D;
+	std::uint8_t loadMode;
+	std::uint8_t loadPolicy;
+	std::uint16_t maxInstances;
+	std::uint8_t stealMode;
+	std::uint8_t reserved;
+	std::uint16_t coalesceWindowMs;
+	std::uint8_t coalesceVolume;
+	std::uint8_t coalescePosition;
+	std::uint16_t fadeInMs;
+	std::uint16_t fadeOutMs;
+	std::uint16_t sequenceIntervalMs;
+	std::uint16_t sequenceOffsetMs;
+	std::int16_t loopCount;
+	std::uint8_t loopUnit;
+	std::uint8_t reserved2;
+	std::uint32_t loopStart;
+	std::uint32_t loopEnd;
+};
+
+static_assert(sizeof(SoundBankHeader) == 48, "SoundBankHeader must not change size");
+static_assert(sizeof(SoundBankEntry) == 80, "SoundBankEntry must not change size");
+
+//Read only view of a memory mapped sound bank
+class SoundBank
+{
+public:
+	bool open(const std::string& path);
+
+	const std::string& path() const noexcept { return m_path; }
+	const File::Stamp& stamp() const noexcept { return m_stamp; }
+
+	std::uint32_t size() const noexcept { return m_pHeader->soundCount; }
+	const SoundBankEntry& entry(const std::uint32_t idx) const noexcept { return m_pEntries[idx]; }
+
+	std::string_view name(const SoundBankEntry& entry) const noexcept;
+	const std::uint8_t* data(const SoundBankEntry& entry) const noexcept;
+	SoundEffectData effectData(const SoundBankEntry& entry) const noexcept;
+
+	static std::uint64_t HashName(const std::string_view& name) noexcept;
+	//Used by the offline packer
+	static bool Write(const std::filesystem::path& output, const std::vector<SoundConfigEntry>& sounds);
+
+private:
+	MappedFile m_mapping;
+	std::string m_path;
+	File::Stamp m_stamp;
+
+	const SoundBankHeader* m_pHeader = nullptr;
+	const SoundBankEntry* m_pEntries = nullptr;
+	const char* m_pNames = nullptr;
+};
\ No newline at end of file
@@ -0,0 +1,330 @@
+#include "SoundConfig.hpp"
+
+#include "Utils/Console.hpp"
+#include "Utils/String.hpp"
+#include "Utils/File.hpp"
+
+#include <unordered_map>
+#include <algorithm>
+
+bool SoundConfig::Load(const std::string& keyRepl, SoundConfigData& r_data)
+{
+	std::string v_configPath = keyRepl + "/sm_cae_config.json";
+	if (!File::Exists(v_configPath))
+	{
+		v_configPath = keyRepl + "/sm_dlm_config.json";
+		if (!File::Exists(v_configPath))
+			return false;
+
+		DebugWarningL(keyRepl, " is using a legacy version of CustomAudioExtension config");
+	}
+
+	simdjson::dom::document v_document;
+	if (!JsonReader::LoadParseSimdjsonCommentsC(
+		String::ToWide(v_configPath),
+		v_document,
+		simdjson::dom::element_type::OBJECT))
+	{
+		DebugErrorL("Couldn't load the CAE sound config file: ", v_configPath);
+		return false;
+	}
+
+	const auto v_bankNode = v_document.root()["bank"];
+	if (v_bankNode.is_string())
+	{
+		r_data.bankPath = v_bankNode.get_string().value_unsafe();
+		SoundConfig::ReplaceContentKey(r_data.bankPath, keyRepl);
+	}
+
+	const auto v_buses = v_document.root()["buses"];
+	if (v_buses.is_object())
+	{
+		for (auto& v_busObj : v_buses.get_object())
+		{
+			const auto v_volumeNode = v_busObj.value["volume"];
+
+			r_data.buses.push_back(SoundConfigBus{
+				.name = std::string(v_busObj.key),
+				.volume = v_volumeNode.is_number() ? JsonReader::GetNumber<float>(v_volumeNode) : 1.0f
+			});
+		}
+	}
+
+	const auto v_soundList = v_document.root()["soundList"];
+	if (!v_soundList.is_object())
+	{
+		if (r_data.bankPath.empty())
+		{
+			DebugErrorL("No sound list: ", v_configPath);
+			return false;
+		}
+
+		return true;
+	}
+
+	for (auto& v_soundListObj : v_soundList.get_object())
+	{
+		if (!v_soundListObj.value.is_object()) continue;
+
+		const auto v_soundPathNode = v_soundListObj.value["path"];
+		if (!v_soundPathNode.is_string()) continue;
+
+		SoundConfigEntry& v_entry = r_data.sounds.emplace_back();
+		v_entry.name = v_soundListObj.key;
+		v_entry.path = v_soundPathNode.get_string().value_unsafe();
+		SoundConfig::ReplaceContentKey(v_entry.path, keyRepl);
+
+		SoundConfig::LoadEffectData(v_soundListObj.value, v_entry.effectData);
+		v_entry.loadPolicy = SoundConfig::GetLoadPolicy(v_soundListObj.value);
+
+		const auto v_busNode = v_soundListObj.value["bus"];
+		if (v_busNode.is_string())
+			v_entry.bus = v_busNode.get_string().value_unsafe();
+	}
+
+	return true;
+}
+
+void SoundConfig::ReplaceContentKey(std::string& path, const std::string_view& keyRepl)
+{
+	if (path.empty() || path[0] != '$')
+		return;
+
+	const std::size_t v_slashIdx = path.find('/');
+	if (v_slashIdx == std::string::npos)
+		return;
+
+	if (std::string_view(path).substr(0, v_slashIdx) != "$CONTENT_DATA")
+		return;
+
+	path.replace(
+		path.begin(),
+		path.begin() + v_slashIdx,
+		keyRepl
+	);
+}
+
+static std::unordered_map<std::string_view, int> g_reverbStringToIdx =
+{
+	{ "MOUNTAINS" , 0 },
+	{ "CAVE"      , 1 },
+	{ "GENERIC"   , 2 },
+	{ "UNDERWATER", 3 }
+};
+
+static int get_reverb_setting(const simdjson::dom::document_stream::iterator::value_type& reverbData)
+{
+	if (!reverbData.is_string()) return -1;
+
+	auto v_iter = g_reverbStringToIdx.find(reverbData.get_string());
+	if (v_iter == g_reverbStringToIdx.end())
+	{
+		DebugErrorL("Invalid reverb preset name: ", reverbData.get_string().value_unsafe());
+		return -1;
+	}
+
+	return v_iter->second;
+}
+
+static std::unordered_map<std::string_view, SoundLoadMode> g_loadModeStringToEnum =
+{
+	{ "auto"      , SoundLoadMode::Auto       },
+	{ "sample"    , SoundLoadMode::Sample     },
+	{ "compressed", SoundLoadMode::Compressed },
+	{ "stream"    , SoundLoadMode::Stream     }
+};
+
+//Sounds are only streamed if the config asks for it, "auto" is opt-in
+static SoundLoadMode get_load_mode(const simdjson::dom::document_stream::iterator::value_type& loadModeData)
+{
+	if (!loadModeData.is_string()) return SoundLoadMode::Sample;
+
+	auto v_iter = g_loadModeStringToEnum.find(loadModeData.get_string());
+	if (v_iter == g_loadModeStringToEnum.end())
+	{
+		DebugErrorL("Invalid sound load mode: ", loadModeData.get_string().value_unsafe());
+		return SoundLoadMode::Sample;
+	}
+
+	return v_iter->second;
+}
+
+static void load_min_max_distance(const simdjson::dom::element& curSound, SoundEffectData& effectData)
+{
+	const auto v_minDistance = curSound["min_distance"];
+	const auto v_maxDistance = curSound["max_distance"];
+
+	effectData.fMinDistance = v_minDistance.is_number() ? JsonReader::GetNumber<float>(v_minDistance) : 0.0f;
+	effectData.fMaxDistance = v_maxDistance.is_number() ? JsonReader::GetNumber<float>(v_maxDistance) : 10000.0f;
+}
+
+static std::unordered_map<std::string_view, SoundStealMode> g_stealModeStringToEnum =
+{
+	{ "oldest"  , SoundStealMode::Oldest   },
+	{ "quietest", SoundStealMode::Quietest },
+	{ "furthest", SoundStealMode::Furthest },
+	{ "none"    , SoundStealMode::None     }
+};
+
+static void load_instance_limit(const simdjson::dom::element& curSound, SoundEffectData& effectData)
+{
+	const auto v_maxInstancesNode = curSound["maxInstances"];
+	const auto v_stealModeNode = curSound["stealMode"];
+
+	effectData.maxInstances = 0;
+	if (v_maxInstancesNode.is_number())
+		effectData.maxInstances = static_cast<std::uint16_t>(std::clamp<long long>(JsonReader::GetNumber<long long>(v_maxInstancesNode), 0, 0xFFFF));
+
+	effectData.stealMode = SoundStealMode::Oldest;
+	if (!v_stealModeNode.is_string()) return;
+
+	auto v_iter = g_stealModeStringToEnum.find(v_stealModeNode.get_string());
+	if (v_iter == g_stealModeStringToEnum.end())
+	{
+		DebugErrorL("Invalid sound steal mode: ", v_stealModeNode.get_string().value_unsafe());
+		return;
+	}
+
+	effectData.stealMode = v_iter->second;
+}
+
+static std::unordered_map<std::string_view, SoundCoalesceVolume> g_coalesceVolumeStringToEnum =
+{
+	{ "sqrt"    , SoundCoalesceVolume::Sqrt     },
+	{ "constant", SoundCoalesceVolume::Constant },
+	{ "log"     , SoundCoalesceVolume::Log      },
+	{ "linear"  , SoundCoalesceVolume::Linear   }
+};
+
+static std::unordered_map<std::string_view, SoundCoalescePosition> g_coalescePositionStringToEnum =
+{
+	{ "nearest", SoundCoalescePosition::Nearest },
+	{ "loudest", SoundCoalescePosition::Loudest }
+};
+
+static void load_coalescing(const simdjson::dom::element& curSound, SoundEffectData& effectData)
+{
+	const auto v_windowNode = curSound["coalesceWindowMs"];
+	const auto v_volumeNode = curSound["coalesceVolume"];
+	const auto v_positionNode = curSound["coalescePosition"];
+
+	effectData.coalesceWindowMs = 0;
+	if (v_windowNode.is_number())
+		effectData.coalesceWindowMs = static_cast<std::uint16_t>(std::clamp<long long>(JsonReader::GetNumber<long long>(v_windowNode), 0, 0xFFFF));
+
+	effectData.coalesceVolume = SoundCoalesceVolume::Sqrt;
+	if (v_volumeNode.is_string())
+	{
+		auto v_iter = g_coalesceVolumeStringToEnum.find(v_volumeNode.get_string());
+		if (v_iter != g_coalesceVolumeStringToEnum.end())
+			effectData.coalesceVolume = v_iter->second;
+		else
+			DebugErrorL("Invalid coalesce volume function: ", v_volumeNode.get_string().value_unsafe());
+	}
+
+	effectData.coalescePosition = SoundCoalescePosition::Nearest;
+	if (v_positionNode.is_string())
+	{
+		auto v_iter = g_coalescePositionStringToEnum.find(v_positionNode.get_string());
+		if (v_iter != g_coalescePositionStringToEnum.end())
+			effectData.coalescePosition = v_iter->second;
+		else
+			DebugErrorL("Invalid coalesce position: ", v_positionNode.get_string().value_unsafe());
+	}
+}
+
+static void load_loop(const simdjson::dom::element& curSound, SoundEffectData& effectData)
+{
+	const auto v_loopNode = curSound["loop"];
+	const auto v_loopCountNode = curSound["loopCount"];
+	const auto v_loopUnitNode = curSound["loopUnit"];
+
+	effectData.loopCount = 0;
+	if (v_loopNode.is_bool() && v_loopNode.get_bool().value_unsafe())
+		effectData.loopCount = -1;
+
+	//A loop count implies "loop": true
+	if (v_loopCountNode.is_number())
+		effectData.loopCount = static_cast<std::int16_t>(std::clamp<long long>(JsonReader::GetNumber<long long>(v_loopCountNode), -1, 0x7FFF));
+
+	effectData.loopUnit = SoundLoopUnit::Ms;
+	if (v_loopUnitNode.is_string())
+	{
+		const std::string_view v_loopUnit = v_loopUnitNode.get_string().value_unsafe();
+		if (v_loopUnit == "samples")
+			effectData.loopUnit = SoundLoopUnit::Samples;
+		else if (v_loopUnit != "ms")
+			DebugErrorL("Invalid loop unit: ", v_loopUnit);
+	}
+
+	const auto v_getLoopPoint = [](const simdjson::dom::element& node) -> std::uint32_t {
+		if (!node.is_number()) return 0;
+		return static_cast<std::uint32_t>(std::clamp<long long>(JsonReader::GetNumber<long long>(node), 0, 0xFFFFFFFF));
+	};
+
+	effectData.loopStart = v_getLoopPoint(curSound["loopStart"]);
+	effectData.loopEnd = v_getLoopPoint(curSound["loopEnd"]);
+
+	if (effectData.loopEnd != 0 && effectData.loopEnd <= effectData.loopStart)
+	{
+		DebugErrorL("The loop end must be after the loop start, the whole sound is looped instead");
+		effectData.loopStart = 0;
+		effectData.loopEnd = 0;
+	}
+}
+
+static std::uint16_t get_time_ms(const simdjson::dom::element& node)
+{
+	if (!node.is_number())
+		return 0;
+
+	//Measured in seconds
+	const double v_time = JsonReader::GetNumber<double>(node);
+	return static_cast<std::uint16_t>(std::clamp(v_time * 1000.0, 0.0, 65535.0));
+}
+
+void SoundConfig::LoadEffectData(const simdjson::dom::element& curSound, SoundEffectData& effectData)
+{
+	const auto v_soundIs3dNode = curSound["is3D"];
+	const auto v_reverbNode = curSound["reverb"];
+	const auto v_loadModeNode = curSound["loadMode"];
+
+	effectData.is3D = v_soundIs3dNode.is_bool() ? v_soundIs3dNode.get_bool().value() : false;
+	effectData.reverbIdx = get_reverb_setting(v_reverbNode);
+	effectData.loadMode = get_load_mode(v_loadModeNode);
+
+	load_min_max_distance(curSound, effectData);
+	load_instance_limit(curSound, effectData);
+	load_coalescing(curSound, effectData);
+	load_loop(curSound, effectData);
+
+	effectData.fadeInMs = get_time_ms(curSound["fadeIn"]);
+	effectData.fadeOutMs = get_time_ms(curSound["fadeOut"]);
+
+	const auto v_sequenceNode = curSound["sequence"];
+	effectData.sequenceIntervalMs = v_sequenceNode.is_object() ? get_time_ms(v_sequenceNode["interval"]) : 0;
+	effectData.sequenceOffsetMs = v_sequenceNode.is_object() ? get_time_ms(v_sequenceNode["offset"]) : 0;
+}
+
+static std::unordered_map<std::string_view, SoundLoadPolicy> g_loadPolicyStringToEnum =
+{
+	{ "queue", SoundLoadPolicy::Queue },
+	{ "wait" , SoundLoadPolicy::Wait  },
+	{ "skip" , SoundLoadPolicy::Skip  }
+};
+
+SoundLoadPolicy SoundConfig::GetLoadPolicy(const simdjson::dom::element& curSound)
+{
+	const auto v_loadPolicyNode = curSound["loadPolicy"];
+	if (!v_loadPolicyNode.is_string())
+		return SoundLoadPolicy::Queue;
+
+	auto v_iter = g_loadPolicyStringToEnum.find(v_loadPolicyNode.get_string());
+	if (v_iter == g_loadPolicyStringToEnum.end())
+	{
+		DebugErrorL("Invalid sound load policy: ", v_loadPolicyNode.get_string().value_unsafe());
+		return SoundLoadPolicy::Queue;
+	}
+
+	return v_iter->second;
+}
\ No newline at end of file
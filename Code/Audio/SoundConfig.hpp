@@ -0,0 +1,55 @@
+#pragma once
+
+#include "SoundData.hpp"
+
+#include "Utils/Json.hpp"
+
+#include <string_view>
+#include <string>
+#include <vector>
+
+struct SoundConfigEntry
+{
+	std::string name;
+	//$CONTENT_DATA is already replaced
+	std::string path;
+	SoundEffectData effectData;
+	SoundLoadPolicy loadPolicy;
+	//Empty if the sound plays on the bus of the mod
+	std::string bus;
+};
+
+struct SoundConfigBus
+{
+	std::string name;
+	float volume;
+};
+
+struct SoundConfigData
+{
+	//Empty if the config doesn't reference a sound bank
+	std::string bankPath;
+	std::vector<SoundConfigBus> buses;
+	std::vector<SoundConfigEntry> sounds;
+};
+
+//Parsing of the sound list entries in sm_cae_config.json, shared with the offline tools
+class SoundConfig
+{
+public:
+	//Reads sm_cae_config.json (or the legacy sm_dlm_config.json) of the mod directory into plain data.
+	//Doesn't touch the sound storage, so it can be called from worker threads
+	static bool Load(const std::string& keyRepl, SoundConfigData& r_data);
+
+	//Replaces $CONTENT_DATA at the start of the path with the mod directory
+	static void ReplaceContentKey(std::string& path, const std::string_view& keyRepl);
+	//Reads is3D, reverb, min_distance, max_distance, loadMode, the instance limit and the coalescing settings
+	static void LoadEffectData(const simdjson::dom::element& curSound, SoundEffectData& effectData);
+	static SoundLoadPolicy GetLoadPolicy(const simdjson::dom::element& curSound);
+
+private:
+	SoundConfig() = default;
+	SoundConfig(const SoundConfig&) = delete;
+	SoundConfig(SoundConfig&&) = delete;
+	~SoundConfig() = default;
+};
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "SoundConfigLoader.hpp"
+
+#include <SmSdk/DirectoryManager.hpp>
+
+#include "Utils/Console.hpp"
+
+#include <algorithm>
+
+void SoundConfigLoader::Start()
+{
+	if (SoundConfigLoader::Started) return;
+	SoundConfigLoader::Started = true;
+
+	DirectoryManager* v_pDirMgr = DirectoryManager::GetInstance();
+	if (!v_pDirMgr) return;
+
+	//The map is owned by the game, so the directories are copied before the workers are started.
+	//Several content keys can point to the same directory
+	for (const auto& [v_key, v_directory] : v_pDirMgr->m_contentKeyToPathList)
+	{
+		if (SoundConfigLoader::SlotIndex.contains(v_directory))
+			continue;
+
+		SoundConfigLoader::SlotIndex.emplace(v_directory, SoundConfigLoader::Slots.size());
+
+		std::unique_ptr<Slot>& v_pSlot = SoundConfigLoader::Slots.emplace_back(std::make_unique<Slot>());
+		v_pSlot->keyRepl = v_directory;
+	}
+
+	const std::size_t v_hwThreads = std::max<std::size_t>(std::thread::hardware_concurrency(), 2);
+	const std::size_t v_threadCount = std::min<std::size_t>({
+		v_hwThreads - 1,
+		CAE_MAX_CONFIG_LOAD_THREADS,
+		SoundConfigLoader::Slots.size()
+	});
+
+	for (std::size_t a = 0; a < v_threadCount; a++)
+		SoundConfigLoader::Workers.emplace_back(SoundConfigLoader::WorkerThread);
+
+	DebugOutL(__FUNCTION__, " -> Reading ", SoundConfigLoader::Slots.size(), " mod configs on ", v_threadCount, " threads");
+}
+
+bool SoundConfigLoader::Take(const std::string& keyRepl, SoundConfigData& r_data)
+{
+	SoundConfigLoader::Start();
+
+	const auto v_iter = SoundConfigLoader::SlotIndex.find(keyRepl);
+	if (v_iter == SoundConfigLoader::SlotIndex.end())
+	{
+		//Not known when the workers were started
+		return SoundConfig::Load(keyRepl, r_data);
+	}
+
+	Slot& v_slot = *SoundConfigLoader::Slots[v_iter->second];
+
+	//Parse it right away instead of waiting for a worker to get to it
+	if (!SoundConfigLoader::TryParse(v_slot))
+	{
+		std::unique_lock v_lock(SoundConfigLoader::ReadyMutex);
+		SoundConfigLoader::ReadyCondition.wait(v_lock,
+			[&v_slot]() { return v_slot.state.load(std::memory_order_acquire) >= SlotState::Ready; });
+	}
+
+	//Every shapeset of a mod asks for the same config, registering it again wouldn't change anything
+	if (v_slot.state.load(std::memory_order_acquire) == SlotState::Taken)
+		return false;
+
+	v_slot.state.store(SlotState::Taken, std::memory_order_relaxed);
+	if (!v_slot.valid)
+		return false;
+
+	r_data = std::move(v_slot.data);
+	return true;
+}
+
+void SoundConfigLoader::Reset()
+{
+	//Makes the workers stop after the config they are currently parsing
+	SoundConfigLoader::NextSlot.store(SoundConfigLoader::Slots.size());
+
+	for (std::thread& v_worker : SoundConfigLoader::Workers)
+		v_worker.join();
+
+	SoundConfigLoader::Workers.clear();
+	SoundConfigLoader::Slots.clear();
+	SoundConfigLoader::SlotIndex.clear();
+	SoundConfigLoader::NextSlot.store(0);
+	SoundConfigLoader::Started = false;
+}
+
+void SoundConfigLoader::WorkerThread()
+{
+	const std::size_t v_slotCount = SoundConfigLoader::Slots.size();
+
+	while (true)
+	{
+		const std::size_t v_idx = SoundConfigLoader::NextSlot.fetch_add(1);
+		if (v_idx >= v_slotCount) break;
+
+		SoundConfigLoader::TryParse(*SoundConfigLoader::Slots[v_idx]);
+	}
+}
+
+bool SoundConfigLoader::TryParse(Slot& slot)
+{
+	SlotState v_expected = SlotState::Pending;
+	if (!slot.state.compare_exchange_strong(v_expected, SlotState::Parsing, std::memory_order_acquire))
+		return false;
+
+	slot.valid = SoundConfig::Load(slot.keyRepl, slot.data);
+
+	{
+		//The state is changed under the lock, so the loading thread can't miss the notification
+		std::lock_guard v_lock(SoundConfigLoader::ReadyMutex);
+		slot.state.store(SlotState::Ready, std::memory_order_release);
+	}
+
+	SoundConfigLoader::ReadyCondition.notify_all();
+	return true;
+}
\ No newline at end of file
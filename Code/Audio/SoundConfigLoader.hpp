@@ -0,0 +1,66 @@
+#pragma once
+
+#include "SoundConfig.hpp"
+
+#include <condition_variable>
+#include <unordered_map>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <string>
+
+#include <cstdint>
+
+#define CAE_MAX_CONFIG_LOAD_THREADS 4
+
+//Reads the sound configs of every known mod on worker threads while the game loads the shapesets.
+//Only the parsing happens in parallel, the sounds are still registered on the loading thread in shapeset order
+class SoundConfigLoader
+{
+public:
+	//Queues the configs of all the content keys the game knows about, called lazily by Take.
+	//That includes every subscribed mod, not only the ones the world uses, the unused results are dropped by Reset
+	static void Start();
+	//Moves the parsed config of the mod directory out, waits only if a worker is still parsing that exact config.
+	//Returns false if the mod has no valid config or if it was already taken during this world load
+	static bool Take(const std::string& keyRepl, SoundConfigData& r_data);
+	//Joins the workers and drops all the results, mods can be added or changed between world loads
+	static void Reset();
+
+private:
+	enum class SlotState : std::uint8_t
+	{
+		Pending,
+		Parsing,
+		Ready,
+		Taken
+	};
+
+	struct Slot
+	{
+		std::string keyRepl;
+		std::atomic<SlotState> state = SlotState::Pending;
+		bool valid = false;
+		SoundConfigData data;
+	};
+
+	static void WorkerThread();
+	//Parses the slot if nobody else has claimed it yet
+	static bool TryParse(Slot& slot);
+
+	inline static std::vector<std::unique_ptr<Slot>> Slots;
+	inline static std::unordered_map<std::string, std::size_t> SlotIndex;
+	inline static std::vector<std::thread> Workers;
+	inline static std::atomic<std::size_t> NextSlot = 0;
+	inline static bool Started = false;
+
+	inline static std::mutex ReadyMutex;
+	inline static std::condition_variable ReadyCondition;
+
+	SoundConfigLoader() = default;
+	SoundConfigLoader(const SoundConfigLoader&) = delete;
+	SoundConfigLoader(SoundConfigLoader&&) = delete;
+	~SoundConfigLoader() = default;
+};
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+enum class SoundLoadMode : std::uint8_t
+{
+	//Sample or Stream, depending on the file size
+	Auto,
+	//Decoded into memory once and shared by all instances
+	Sample,
+	//Kept compressed in memory and decoded while playing
+	Compressed,
+	//Read from the disk while playing, every instance opens its own stream
+	Stream
+};
+
+//Which instance gives up its voice once maxInstances is reached
+enum class SoundStealMode : std::uint8_t
+{
+	Oldest,
+	//Lowest audibility, includes the distance attenuation
+	Quietest,
+	//Furthest away from the listener
+	Furthest,
+	//The new instance isn't created
+	None
+};
+
+//How the volume of a coalesced voice grows with the number of merged triggers
+enum class SoundCoalesceVolume : std::uint8_t
+{
+	Sqrt,
+	Constant,
+	//1 + log2(count)
+	Log,
+	Linear
+};
+
+//Which of the merged triggers the coalesced voice plays from
+enum class SoundCoalescePosition : std::uint8_t
+{
+	Nearest,
+	Loudest
+};
+
+//Unit of the loop points in the sound config
+enum class SoundLoopUnit : std::uint8_t
+{
+	Ms,
+	Samples
+};
+
+struct SoundEffectData
+{
+	SoundLoadMode loadMode;
+	bool is3D;
+	int reverbIdx;
+	float fMinDistance;
+	float fMaxDistance;
+	//0 - unlimited
+	std::uint16_t maxInstances;
+	SoundStealMode stealMode;
+	//0 - every trigger gets its own voice
+	std::uint16_t coalesceWindowMs;
+	SoundCoalesceVolume coalesceVolume;
+	SoundCoalescePosition coalescePosition;
+	//0 - the sound starts and stops at full volume
+	std::uint16_t fadeInMs;
+	std::uint16_t fadeOutMs;
+	//0 - the sound starts right away, otherwise starts are moved to the next multiple of the interval plus the offset
+	std::uint16_t sequenceIntervalMs;
+	std::uint16_t sequenceOffsetMs;
+	//Same as Channel::setLoopCount: 0 - plays once, -1 - loops forever
+	std::int16_t loopCount;
+	SoundLoopUnit loopUnit;
+	//loopEnd 0 - the loop region ends at the end of the sound
+	std::uint32_t loopStart;
+	std::uint32_t loopEnd;
+};
+
+//What createInstance does with a sound that is still loading
+enum class SoundLoadPolicy : std::uint8_t
+{
+	//Create the instance right away, it starts playing once the sound is ready
+	Queue,
+	//Block until the sound is ready
+	Wait,
+	//Fail the instance creation, the effect stays silent
+	Skip
+};
+
+struct SoundData
+{
+	SoundEffectData effectData;
+	//Only used in diagnostics, lookups go through the name hash
+	std::string name;
+	std::uint32_t pathId;
+	SoundLoadPolicy loadPolicy;
+	//SoundMixer bus the instances are played on
+	std::uint32_t busId;
+	//Handles of the live instances in creation order, only tracked if maxInstances is set.
+	//Only the active ones count against the limit, the others can get a voice again when they are restarted
+	std::vector<std::uint64_t> liveInstances;
+	//The instance that later triggers are merged into, only used if coalesceWindowMs is set
+	std::uint64_t coalesceLeader = 0;
+	double coalesceStartMs = 0.0;
+};
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "SoundLoadQueue.hpp"
+#include "SoundStorage.hpp"
+
+#include "Utils/Console.hpp"
+
+#include <algorithm>
+
+void SoundLoadQueue::Request(const std::uint32_t pathId, const SoundLoadPriority priority)
+{
+	SoundPath& v_path = SoundStorage::Paths[pathId];
+	if (v_path.sound || v_path.resolvedMode == SoundLoadMode::Stream)
+		return;
+
+	if (v_path.loadQueued)
+	{
+		Clock::time_point v_requestTime;
+		if (priority == SoundLoadPriority::High && SoundLoadQueue::RemoveQueued(SoundLoadQueue::LowQueue, pathId, v_requestTime))
+			SoundLoadQueue::HighQueue.push_back(QueuedLoad{ pathId, v_requestTime });
+
+		return;
+	}
+
+	v_path.loadQueued = true;
+
+	std::deque<QueuedLoad>& v_queue = (priority == SoundLoadPriority::High) ? SoundLoadQueue::HighQueue : SoundLoadQueue::LowQueue;
+	v_queue.push_back(QueuedLoad{ pathId, Clock::now() });
+}
+
+FMOD::Sound* SoundLoadQueue::Start(const std::uint32_t pathId)
+{
+	SoundPath& v_path = SoundStorage::Paths[pathId];
+	if (v_path.sound)
+		return v_path.sound;
+
+	Clock::time_point v_requestTime = Clock::now();
+	if (v_path.loadQueued)
+	{
+		if (!SoundLoadQueue::RemoveQueued(SoundLoadQueue::HighQueue, pathId, v_requestTime))
+			SoundLoadQueue::RemoveQueued(SoundLoadQueue::LowQueue, pathId, v_requestTime);
+
+		v_path.loadQueued = false;
+	}
+
+	return SoundLoadQueue::StartLoad(pathId, v_requestTime);
+}
+
+bool SoundLoadQueue::Update()
+{
+	std::vector<FinishedLoad> v_finishedLoads;
+	{
+		std::lock_guard v_lock(SoundLoadQueue::FinishedMutex);
+		v_finishedLoads.swap(SoundLoadQueue::FinishedLoads);
+	}
+
+	bool v_anyFinished = false;
+	bool v_anyStarted = false;
+	for (const FinishedLoad& v_finished : v_finishedLoads)
+	{
+		FMOD::Sound* v_pSound = reinterpret_cast<FMOD::Sound*>(v_finished.sound);
+
+		auto v_iter = std::find_if(SoundLoadQueue::ActiveLoads.begin(), SoundLoadQueue::ActiveLoads.end(),
+			[v_pSound](const ActiveLoad& load) { return load.sound == v_pSound; });
+
+		//Callbacks of other non blocking operations are not tracked
+		if (v_iter == SoundLoadQueue::ActiveLoads.end())
+			continue;
+
+		if (v_finished.result == FMOD_OK)
+			SoundLoadQueue::AddLatencySample(v_iter->requestTime, v_finished.finishTime);
+		else
+			DebugErrorL("Couldn't load a sound, FMOD error: ", static_cast<int>(v_finished.result));
+
+		//Sounds that were released while loading are forgotten, so the path still holds this sound
+		const std::uint32_t v_pathId = SoundStorage::PathIndex.find(v_iter->pathKey);
+		if (v_pathId != SoundStorage::InvalidId)
+			SoundStorage::OnSoundLoaded(v_pathId);
+
+		*v_iter = SoundLoadQueue::ActiveLoads.back();
+		SoundLoadQueue::ActiveLoads.pop_back();
+
+		v_anyFinished = true;
+	}
+
+	while (SoundLoadQueue::ActiveLoads.size() < CAE_MAX_ACTIVE_SOUND_LOADS)
+	{
+		std::deque<QueuedLoad>& v_queue = !SoundLoadQueue::HighQueue.empty() ? SoundLoadQueue::HighQueue : SoundLoadQueue::LowQueue;
+		if (v_queue.empty()) break;
+
+		const QueuedLoad v_load = v_queue.front();
+		v_queue.pop_front();
+
+		SoundStorage::Paths[v_load.pathId].loadQueued = false;
+
+		//Cache hits are ready as soon as they are created
+		FMOD::Sound* v_pSound = SoundLoadQueue::StartLoad(v_load.pathId, v_load.requestTime);
+		if (v_pSound && SoundStorage::IsSoundReady(v_pSound))
+			v_anyFinished = true;
+
+		v_anyStarted = true;
+	}
+
+	//Loads that were just started count with their file size, so the budget also holds during a burst of loads
+	if (v_anyFinished || v_anyStarted)
+		SoundStorage::EnforceMemoryBudget();
+
+	return v_anyFinished;
+}
+
+void SoundLoadQueue::Clear()
+{
+	for (const QueuedLoad& v_load : SoundLoadQueue::HighQueue)
+		SoundStorage::Paths[v_load.pathId].loadQueued = false;
+
+	for (const QueuedLoad& v_load : SoundLoadQueue::LowQueue)
+		SoundStorage::Paths[v_load.pathId].loadQueued = false;
+
+	SoundLoadQueue::HighQueue.clear();
+	SoundLoadQueue::LowQueue.clear();
+}
+
+void SoundLoadQueue::Forget(FMOD::Sound* sound)
+{
+	std::erase_if(SoundLoadQueue::ActiveLoads, [sound](const ActiveLoad& load) { return load.sound == sound; });
+
+	//The address can be reused by the next sound, so the pending callback must not be matched against it
+	std::lock_guard v_lock(SoundLoadQueue::FinishedMutex);
+	std::erase_if(SoundLoadQueue::FinishedLoads,
+		[sound](const FinishedLoad& load) { return reinterpret_cast<FMOD::Sound*>(load.sound) == sound; });
+}
+
+void SoundLoadQueue::LogStats()
+{
+	std::vector<float>& v_samples = SoundLoadQueue::LatencySamples;
+	if (v_samples.empty()) return;
+
+	std::sort(v_samples.begin(), v_samples.end());
+
+	const auto v_percentile = [&v_samples](const std::size_t percent) -> float {
+		return v_samples[(v_samples.size() - 1) * percent / 100];
+	};
+
+	DebugOutL(__FUNCTION__, " -> Sound load latency over ", v_samples.size(), " loads: p50: ", v_percentile(50),
+		"ms, p90: ", v_percentile(90), "ms, p99: ", v_percentile(99), "ms, max: ", v_samples.back(), "ms");
+
+	v_samples.clear();
+}
+
+bool SoundLoadQueue::WaitForLoad(FMOD::Sound* sound, const Clock::duration timeout)
+{
+	FMOD_SOUND* v_pSound = reinterpret_cast<FMOD_SOUND*>(sound);
+	FMOD_RESULT v_result = FMOD_ERR_NOTREADY;
+
+	//The finished loads are only taken out by Update, which runs on this thread, so a load that finished earlier is still in the list
+	std::unique_lock v_lock(SoundLoadQueue::FinishedMutex);
+	SoundLoadQueue::FinishedCondition.wait_for(v_lock, timeout, [v_pSound, &v_result]() {
+		for (const FinishedLoad& v_finished : SoundLoadQueue::FinishedLoads)
+		{
+			if (v_finished.sound == v_pSound)
+			{
+				v_result = v_finished.result;
+				return true;
+			}
+		}
+
+		return false;
+	});
+
+	return v_result == FMOD_OK;
+}
+
+FMOD_RESULT F_CALLBACK SoundLoadQueue::OnSoundLoaded(FMOD_SOUND* sound, FMOD_RESULT result)
+{
+	{
+		std::lock_guard v_lock(SoundLoadQueue::FinishedMutex);
+		SoundLoadQueue::FinishedLoads.push_back(FinishedLoad{ sound, result, Clock::now() });
+	}
+
+	SoundLoadQueue::FinishedCondition.notify_all();
+	return FMOD_OK;
+}
+
+bool SoundLoadQueue::RemoveQueued(std::deque<QueuedLoad>& queue, const std::uint32_t pathId, Clock::time_point& r_requestTime)
+{
+	auto v_iter = std::find_if(queue.begin(), queue.end(),
+		[pathId](const QueuedLoad& load) { return load.pathId == pathId; });
+
+	if (v_iter == queue.end())
+		return false;
+
+	r_requestTime = v_iter->requestTime;
+	queue.erase(v_iter);
+
+	return true;
+}
+
+FMOD::Sound* SoundLoadQueue::StartLoad(const std::uint32_t pathId, const Clock::time_point requestTime)
+{
+	FMOD::Sound* v_pSound = SoundStorage::CreateSound(pathId);
+	if (!v_pSound) return nullptr;
+
+	if (SoundStorage::IsSoundReady(v_pSound))
+	{
+		SoundLoadQueue::AddLatencySample(requestTime, Clock::now());
+		SoundStorage::OnSoundLoaded(pathId);
+	}
+	else
+	{
+		SoundStorage::AddPendingLoad(pathId);
+		SoundLoadQueue::ActiveLoads.push_back(ActiveLoad{ v_pSound, SoundStorage::GetPathKey(pathId), requestTime });
+	}
+
+	return v_pSound;
+}
+
+void SoundLoadQueue::AddLatencySample(const Clock::time_point requestTime, const Clock::time_point finishTime)
+{
+	SoundLoadQueue::LatencySamples.push_back(
+		std::chrono::duration<float, std::milli>(finishTime - requestTime).count());
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <fmod/fmod.hpp>
+
+#include <condition_variable>
+#include <chrono>
+#include <vector>
+#include <deque>
+#include <mutex>
+
+#include <cstdint>
+#include <cstddef>
+
+//FMOD loads non blocking sounds one by one on its async thread, so only a few loads are handed
+//to FMOD at a time. Everything else waits in the queue, where sounds that are needed right now can skip ahead
+#define CAE_MAX_ACTIVE_SOUND_LOADS 2
+
+enum class SoundLoadPriority : std::uint8_t
+{
+	//Sounds registered while the world is loading
+	Low,
+	//Sounds that were looked up or played this frame
+	High
+};
+
+class SoundLoadQueue
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	//Queues the shared sound of the path, requesting a queued sound with a higher priority moves it to the front
+	static void Request(const std::uint32_t pathId, const SoundLoadPriority priority);
+	//Hands the sound to FMOD right away, even if the active load limit is reached
+	static FMOD::Sound* Start(const std::uint32_t pathId);
+
+	//Processes finished loads and starts the next queued ones. Returns true if any sound has finished loading
+	static bool Update();
+	//Drops the queued requests, path ids are not stable across reloads
+	static void Clear();
+	//Must be called before a sound that might still be loading is released
+	static void Forget(FMOD::Sound* sound);
+	//Blocks until FMOD reports that the sound has finished loading or the timeout expires.
+	//Returns true if the sound loaded successfully, the load is processed by the next Update as usual
+	static bool WaitForLoad(FMOD::Sound* sound, const Clock::duration timeout);
+
+	//Logs the request to ready latency percentiles since the last call
+	static void LogStats();
+
+	static FMOD_RESULT F_CALLBACK OnSoundLoaded(FMOD_SOUND* sound, FMOD_RESULT result);
+
+private:
+	struct QueuedLoad
+	{
+		std::uint32_t pathId;
+		Clock::time_point requestTime;
+	};
+
+	struct ActiveLoad
+	{
+		FMOD::Sound* sound;
+		//Path ids change on reload, the key finds the path again once the load has finished
+		std::size_t pathKey;
+		Clock::time_point requestTime;
+	};
+
+	struct FinishedLoad
+	{
+		FMOD_SOUND* sound;
+		FMOD_RESULT result;
+		Clock::time_point finishTime;
+	};
+
+	static bool RemoveQueued(std::deque<QueuedLoad>& queue, const std::uint32_t pathId, Clock::time_point& r_requestTime);
+	static FMOD::Sound* StartLoad(const std::uint32_t pathId, const Clock::time_point requestTime);
+	static void AddLatencySample(const Clock::time_point requestTime, const Clock::time_point finishTime);
+
+	inline static std::deque<QueuedLoad> HighQueue;
+	inline static std::deque<QueuedLoad> LowQueue;
+	inline static std::vector<ActiveLoad> ActiveLoads;
+	inline static std::vector<float> LatencySamples;
+
+	//Filled by the FMOD async thread
+	inline static std::mutex FinishedMutex;
+	inline static std::condition_variable FinishedCondition;
+	inline static std::vector<FinishedLoad> FinishedLoads;
+
+	SoundLoadQueue() = default;
+	SoundLoadQueue(const SoundLoadQueue&) = delete;
+	SoundLoadQueue(SoundLoadQueue&&) = delete;
+	~SoundLoadQueue() = default;
+};
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "SoundMixer.hpp"
+#include "AudioSettings.hpp"
+
+#include <SmSdk/AudioManager.hpp>
+#include <SmSdk/GameSettings.hpp>
+#include <SmSdk/win_include.hpp>
+
+#include "Utils/Console.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static std::string get_category_key(const std::uint32_t modBus, const std::string& name)
+{
+	return std::to_string(modBus) + "|" + name;
+}
+
+FMOD::System* SoundMixer::GetSystem()
+{
+	AudioManager* v_pAudioMgr = AudioManager::GetInstance();
+	if (!v_pAudioMgr || !v_pAudioMgr->fmod_system)
+		return nullptr;
+
+	//The groups belong to the FMOD system they were created by
+	if (SoundMixer::System != v_pAudioMgr->fmod_system)
+	{
+		SoundMixer::System = v_pAudioMgr->fmod_system;
+		SoundMixer::RootGroup = nullptr;
+
+		for (SoundBus& v_bus : SoundMixer::Buses)
+			v_bus.group = nullptr;
+	}
+
+	return SoundMixer::System;
+}
+
+FMOD::ChannelGroup* SoundMixer::CreateGroup(const char* name, FMOD::ChannelGroup* parent)
+{
+	FMOD::ChannelGroup* v_pGroup;
+	if (SoundMixer::System->createChannelGroup(name, &v_pGroup) != FMOD_OK)
+	{
+		DebugErrorL("Couldn't create the channel group: ", name);
+		return nullptr;
+	}
+
+	if (parent)
+		parent->addGroup(v_pGroup);
+
+	if (AudioSettings::BusMetering)
+	{
+		FMOD::DSP* v_pHead;
+		if (v_pGroup->getDSP(FMOD_CHANNELCONTROL_DSP_HEAD, &v_pHead) == FMOD_OK)
+			v_pHead->setMeteringEnabled(false, true);
+	}
+
+	return v_pGroup;
+}
+
+FMOD::ChannelGroup* SoundMixer::GetRootGroup()
+{
+	if (!SoundMixer::GetSystem())
+		return nullptr;
+
+	if (SoundMixer::RootGroup)
+		return SoundMixer::RootGroup;
+
+	//Created groups are attached to the master group by FMOD
+	SoundMixer::RootGroup = SoundMixer::CreateGroup("CAE", nullptr);
+	if (!SoundMixer::RootGroup)
+		return nullptr;
+
+	SoundMixer::EffectsVolume = GameSettings::GetEffectsVolume();
+	SoundMixer::RootGroup->setVolume(SoundMixer::EffectsVolume);
+
+	return SoundMixer::RootGroup;
+}
+
+FMOD::ChannelGroup* SoundMixer::GetGroup(const std::uint32_t busId)
+{
+	FMOD::ChannelGroup* v_pRootGroup = SoundMixer::GetRootGroup();
+	if (!v_pRootGroup || busId >= SoundMixer::Buses.size())
+		return v_pRootGroup;
+
+	SoundBus& v_bus = SoundMixer::Buses[busId];
+	if (v_bus.group)
+		return v_bus.group;
+
+	FMOD::ChannelGroup* v_pParent = (v_bus.parent == InvalidBus) ? v_pRootGroup : SoundMixer::GetGroup(v_bus.parent);
+
+	v_bus.group = SoundMixer::CreateGroup(v_bus.name.c_str(), v_pParent);
+	if (!v_bus.group)
+		return v_pParent;
+
+	v_bus.group->setVolume(v_bus.volume);
+	return v_bus.group;
+}
+
+std::uint32_t SoundMixer::AddBus(const std::string& key, const std::string& name, const std::uint32_t parent, const float volume)
+{
+	const std::uint32_t v_busId = static_cast<std::uint32_t>(SoundMixer::Buses.size());
+
+	SoundMixer::Buses.push_back(SoundBus{ .name = name, .parent = parent, .volume = volume });
+	SoundMixer::BusIndex.emplace(key, v_busId);
+
+	return v_busId;
+}
+
+std::uint32_t SoundMixer::GetModBus(const std::string& modPath, const std::string_view& modKey)
+{
+	const auto v_iter = SoundMixer::BusIndex.find(modPath);
+	if (v_iter != SoundMixer::BusIndex.end())
+		return v_iter->second;
+
+	const std::uint32_t v_busId = SoundMixer::AddBus(modPath, modPath, InvalidBus, 1.0f);
+	SoundMixer::Buses[v_busId].modKey = modKey;
+
+	return v_busId;
+}
+
+std::uint32_t SoundMixer::GetBus(const std::uint32_t modBus, const std::string& name, const float volume)
+{
+	const std::string v_key = get_category_key(modBus, name);
+
+	const auto v_iter = SoundMixer::BusIndex.find(v_key);
+	if (v_iter == SoundMixer::BusIndex.end())
+		return SoundMixer::AddBus(v_key, name, modBus, volume);
+
+	SoundBus& v_bus = SoundMixer::Buses[v_iter->second];
+	if (v_bus.volume != volume)
+	{
+		v_bus.volume = volume;
+		if (v_bus.group)
+			v_bus.group->setVolume(volume);
+	}
+
+	return v_iter->second;
+}
+
+std::uint32_t SoundMixer::FindBus(const std::uint32_t modBus, const std::string& name)
+{
+	const auto v_iter = SoundMixer::BusIndex.find(get_category_key(modBus, name));
+	if (v_iter == SoundMixer::BusIndex.end())
+		return InvalidBus;
+
+	return v_iter->second;
+}
+
+const std::string& SoundMixer::GetModKey(std::uint32_t busId)
+{
+	static const std::string v_emptyKey;
+	if (busId >= SoundMixer::Buses.size())
+		return v_emptyKey;
+
+	//Category buses are direct children of their mod bus
+	const std::uint32_t v_parent = SoundMixer::Buses[busId].parent;
+	if (v_parent != InvalidBus)
+		busId = v_parent;
+
+	return SoundMixer::Buses[busId].modKey;
+}
+
+void SoundMixer::Update()
+{
+	const float v_effectsVolume = GameSettings::GetEffectsVolume();
+	if (v_effectsVolume != SoundMixer::EffectsVolume)
+	{
+		SoundMixer::EffectsVolume = v_effectsVolume;
+
+		FMOD::ChannelGroup* v_pGroup = SoundMixer::GetRootGroup();
+		if (v_pGroup)
+			v_pGroup->setVolume(v_effectsVolume);
+	}
+
+	if (!AudioSettings::BusMetering)
+		return;
+
+	const std::uint64_t v_nowMs = GetTickCount64();
+	if (v_nowMs - SoundMixer::LastMeterLogMs < CAE_BUS_METERING_INTERVAL_MS)
+		return;
+
+	SoundMixer::LastMeterLogMs = v_nowMs;
+	SoundMixer::LogMeters();
+}
+
+static void log_group_meter(const std::string_view& name, FMOD::ChannelGroup* group)
+{
+	FMOD::DSP* v_pHead;
+	FMOD_DSP_METERING_INFO v_info = {};
+	if (group->getDSP(FMOD_CHANNELCONTROL_DSP_HEAD, &v_pHead) != FMOD_OK ||
+		v_pHead->getMeteringInfo(nullptr, &v_info) != FMOD_OK)
+	{
+		return;
+	}
+
+	float v_peak = 0.0f, v_rms = 0.0f;
+	for (short a = 0; a < v_info.numchannels; a++)
+	{
+		v_peak = std::max(v_peak, v_info.peaklevel[a]);
+		v_rms = std::max(v_rms, v_info.rmslevel[a]);
+	}
+
+	const auto v_toDecibels = [](const float level) -> float {
+		return 20.0f * std::log10(std::max(level, 0.00001f));
+	};
+
+	DebugOutL("  ", name, ": peak ", v_toDecibels(v_peak), " dB, rms ", v_toDecibels(v_rms), " dB");
+}
+
+void SoundMixer::LogMeters()
+{
+	if (!SoundMixer::RootGroup) return;
+
+	DebugOutL(__FUNCTION__, " -> CAE bus levels:");
+	log_group_meter("CAE", SoundMixer::RootGroup);
+
+	for (const SoundBus& v_bus : SoundMixer::Buses)
+		if (v_bus.group)
+			log_group_meter(v_bus.name, v_bus.group);
+}
\ No newline at end of file
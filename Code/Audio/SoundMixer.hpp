@@ -0,0 +1,76 @@
+#pragma once
+
+#include <fmod/fmod.hpp>
+
+#include <unordered_map>
+#include <string_view>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+//How often the bus levels are logged if bus metering is enabled
+#define CAE_BUS_METERING_INTERVAL_MS 5000
+
+struct SoundBus
+{
+	std::string name;
+	//$CONTENT_ key of the mod, only set for mod buses
+	std::string modKey;
+	//SoundMixer::InvalidBus if the bus is a direct child of the root group
+	std::uint32_t parent;
+	float volume;
+	//Created on the first use
+	FMOD::ChannelGroup* group = nullptr;
+};
+
+//Channel group hierarchy of the extension: the CAE root group, one bus per mod and optional category buses
+//declared in the mod config. The game volume settings are applied to the root group once, instead of being
+//multiplied into the volume of every channel, and bulk operations on a bus are a single call on its group
+class SoundMixer
+{
+public:
+	static constexpr std::uint32_t InvalidBus = 0xFFFFFFFF;
+
+	//Creates the group on the first call, returns nullptr if the FMOD system isn't ready yet
+	static FMOD::ChannelGroup* GetRootGroup();
+	//Returns the root group for SoundMixer::InvalidBus
+	static FMOD::ChannelGroup* GetGroup(const std::uint32_t busId);
+
+	//Bus ids stay the same across world reloads. The bus is keyed by the mod path, the content key is only stored for reports
+	static std::uint32_t GetModBus(const std::string& modPath, const std::string_view& modKey);
+	//Registers the category bus of a mod or updates its volume
+	static std::uint32_t GetBus(const std::uint32_t modBus, const std::string& name, const float volume);
+	//Returns SoundMixer::InvalidBus if the mod doesn't declare the bus
+	static std::uint32_t FindBus(const std::uint32_t modBus, const std::string& name);
+	//$CONTENT_ key of the mod that owns the bus, empty for SoundMixer::InvalidBus
+	static const std::string& GetModKey(std::uint32_t busId);
+
+	//Called once per frame, pushes the effects volume to the root group if it has changed since the last frame
+	static void Update();
+	//Logs the peak and RMS level of every bus that has a group
+	static void LogMeters();
+
+	//Effects volume multiplied by the master volume, as of the last Update
+	inline static float EffectsVolume = 1.0f;
+
+private:
+	//Forgets the groups if the game has created a new FMOD system
+	static FMOD::System* GetSystem();
+	static FMOD::ChannelGroup* CreateGroup(const char* name, FMOD::ChannelGroup* parent);
+	static std::uint32_t AddBus(const std::string& key, const std::string& name, const std::uint32_t parent, const float volume);
+
+	inline static FMOD::System* System = nullptr;
+	inline static FMOD::ChannelGroup* RootGroup = nullptr;
+
+	inline static std::vector<SoundBus> Buses;
+	//Mod path for mod buses, mod bus id and the name for category buses
+	inline static std::unordered_map<std::string, std::uint32_t> BusIndex;
+
+	inline static std::uint64_t LastMeterLogMs = 0;
+
+	SoundMixer() = default;
+	SoundMixer(const SoundMixer&) = delete;
+	SoundMixer(SoundMixer&&) = delete;
+	~SoundMixer() = default;
+};
\ No newline at end of file
@@ -0,0 +1,852 @@
+#include "SoundStorage.hpp"
+#include "SoundLoadQueue.hpp"
+#include "SoundBank.hpp"
+#include "AudioSettings.hpp"
+#include "PcmCache.hpp"
+
+#include <SmSdk/AudioManager.hpp>
+#include <SmSdk/win_include.hpp>
+
+#include "Utils/Console.hpp"
+#include "Utils/Hash.hpp"
+
+#include <algorithm>
+
+static std::size_t hash_path(const std::string_view& path, const SoundLoadMode loadMode) noexcept
+{
+	return std::hash<std::string_view>{}(path) ^ (static_cast<std::size_t>(loadMode) * 0x9E3779B97F4A7C15ull);
+}
+
+static std::size_t hash_content_key(const std::uint64_t value, const SoundLoadMode loadMode) noexcept
+{
+	return static_cast<std::size_t>(value) ^ (static_cast<std::size_t>(loadMode) * 0x9E3779B97F4A7C15ull);
+}
+
+static SoundLoadMode resolve_load_mode(const SoundLoadMode loadMode, const File::Stamp& stamp) noexcept
+{
+	if (loadMode != SoundLoadMode::Auto)
+		return loadMode;
+
+	if (AudioSettings::StreamSizeThreshold != 0 && stamp.size >= AudioSettings::StreamSizeThreshold)
+		return SoundLoadMode::Stream;
+
+	return SoundLoadMode::Sample;
+}
+
+static void lru_unlink(SoundPath& path)
+{
+	if (!path.inLru) return;
+
+	if (path.lruPrev != SoundStorage::InvalidId)
+		SoundStorage::Paths[path.lruPrev].lruNext = path.lruNext;
+	else
+		SoundStorage::LruHead = path.lruNext;
+
+	if (path.lruNext != SoundStorage::InvalidId)
+		SoundStorage::Paths[path.lruNext].lruPrev = path.lruPrev;
+	else
+		SoundStorage::LruTail = path.lruPrev;
+
+	path.lruPrev = SoundStorage::InvalidId;
+	path.lruNext = SoundStorage::InvalidId;
+	path.inLru = false;
+}
+
+static void lru_push_back(const std::uint32_t pathId)
+{
+	SoundPath& v_path = SoundStorage::Paths[pathId];
+
+	v_path.lruPrev = SoundStorage::LruTail;
+	v_path.lruNext = SoundStorage::InvalidId;
+	v_path.inLru = true;
+
+	if (SoundStorage::LruTail != SoundStorage::InvalidId)
+		SoundStorage::Paths[SoundStorage::LruTail].lruNext = pathId;
+	else
+		SoundStorage::LruHead = pathId;
+
+	SoundStorage::LruTail = pathId;
+}
+
+static void lru_clear()
+{
+	for (SoundPath& v_path : SoundStorage::Paths)
+	{
+		v_path.lruPrev = SoundStorage::InvalidId;
+		v_path.lruNext = SoundStorage::InvalidId;
+		v_path.inLru = false;
+	}
+
+	SoundStorage::LruHead = SoundStorage::InvalidId;
+	SoundStorage::LruTail = SoundStorage::InvalidId;
+}
+
+static void drop_pending_load(SoundPath& path)
+{
+	SoundStorage::PendingBytes -= path.pendingBytes;
+	path.pendingBytes = 0;
+}
+
+void SoundStorage::ClearSounds()
+{
+	SoundLoadQueue::Clear();
+
+	for (SoundPath& v_path : SoundStorage::Paths)
+		SoundStorage::ReleasePathSound(v_path);
+
+	for (RetiredSound& v_retired : SoundStorage::RetiredSounds)
+	{
+		SoundLoadQueue::Forget(v_retired.sound);
+		v_retired.sound->release();
+	}
+
+	SoundStorage::RetiredSounds.clear();
+	SoundStorage::Sounds.clear();
+	SoundStorage::Paths.clear();
+	SoundStorage::Banks.clear();
+
+	SoundStorage::NameIndex.clear();
+	SoundStorage::PathIndex.clear();
+	SoundStorage::SizeIndex.clear();
+	SoundStorage::ContentIndex.clear();
+
+	SoundStorage::ReloadStats = SoundReloadStats{};
+	SoundStorage::ResidentBytes = 0;
+	SoundStorage::PendingBytes = 0;
+
+	SoundStorage::LruHead = InvalidId;
+	SoundStorage::LruTail = InvalidId;
+}
+
+void SoundStorage::BeginReload()
+{
+	SoundReloadStats& v_stats = SoundStorage::ReloadStats;
+
+	SoundLoadQueue::Clear();
+
+	//Count what the duplicates would have taken if they were loaded separately
+	std::uint64_t v_savedBytes = 0;
+	for (SoundPath& v_path : SoundStorage::Paths)
+	{
+		if (v_path.duplicateOf == SoundStorage::InvalidId)
+			continue;
+
+		if (v_path.generation == SoundStorage::Generation)
+			v_savedBytes += SoundStorage::Paths[v_path.duplicateOf].memoryBytes;
+
+		v_path.duplicateOf = SoundStorage::InvalidId;
+	}
+
+	SoundStorage::Sounds.clear();
+	SoundStorage::NameIndex.clear();
+	SoundStorage::PathIndex.clear();
+	SoundStorage::SizeIndex.clear();
+	SoundStorage::ContentIndex.clear();
+
+	//The links are path ids, so the list is built again once the table is compacted
+	lru_clear();
+
+	//Compact the path table, the sound data that references path ids was cleared above
+	std::size_t v_writeIdx = 0;
+	for (std::size_t a = 0; a < SoundStorage::Paths.size(); a++)
+	{
+		SoundPath& v_path = SoundStorage::Paths[a];
+		if (v_path.generation != SoundStorage::Generation)
+		{
+			if (v_path.sound)
+			{
+				//Instances from older world loads can still be playing the sound
+				SoundStorage::RetirePathSound(v_path);
+				v_stats.unloaded++;
+			}
+
+			continue;
+		}
+
+		//The instance count is kept, instances from the previous world can still be playing the sound
+		if (v_writeIdx != a)
+			SoundStorage::Paths[v_writeIdx] = std::move(v_path);
+
+		const SoundPath& v_keptPath = SoundStorage::Paths[v_writeIdx];
+		SoundStorage::PathIndex.insert(
+			hash_path(v_keptPath.path, v_keptPath.loadMode),
+			static_cast<std::uint32_t>(v_writeIdx)
+		);
+
+		v_writeIdx++;
+	}
+
+	SoundStorage::Paths.erase(SoundStorage::Paths.begin() + v_writeIdx, SoundStorage::Paths.end());
+
+	std::vector<std::uint32_t> v_loadedPaths;
+	for (std::uint32_t a = 0; a < SoundStorage::Paths.size(); a++)
+		if (SoundStorage::Paths[a].memoryBytes != 0)
+			v_loadedPaths.push_back(a);
+
+	std::sort(v_loadedPaths.begin(), v_loadedPaths.end(), [](const std::uint32_t lhs, const std::uint32_t rhs) {
+		return SoundStorage::Paths[lhs].lastUsed < SoundStorage::Paths[rhs].lastUsed;
+	});
+
+	for (const std::uint32_t v_pathId : v_loadedPaths)
+		lru_push_back(v_pathId);
+
+	//Banks are closed once none of the kept paths reference them
+	std::erase_if(SoundStorage::Banks,
+		[](const std::shared_ptr<const SoundBank>& bank) { return bank.use_count() == 1; });
+
+	//The stats are collected while the sounds are registered, so they describe the world load that has just ended
+	DebugOutL(__FUNCTION__, " -> Previous world load: Kept: ", v_stats.kept, ", Loaded: ", v_stats.loaded,
+		", Reloaded: ", v_stats.reloaded, ", Unloaded now: ", v_stats.unloaded);
+	DebugOutL(__FUNCTION__, " -> Previous world load: Deduplicated: ", v_stats.deduplicated, ", Saved: ", v_savedBytes / 1024, " KB");
+	SoundLoadQueue::LogStats();
+
+	v_stats = SoundReloadStats{};
+	SoundStorage::Generation++;
+}
+
+std::size_t SoundStorage::HashName(const std::string_view& name) noexcept
+{
+	return std::hash<std::string_view>{}(name);
+}
+
+std::uint32_t SoundStorage::FindSoundId(const std::size_t nameHash)
+{
+	return SoundStorage::NameIndex.find(nameHash);
+}
+
+std::uint32_t SoundStorage::FindSoundId(const std::string_view& name)
+{
+	return SoundStorage::NameIndex.find(SoundStorage::HashName(name));
+}
+
+SoundData* SoundStorage::GetSoundData(const std::uint32_t soundId)
+{
+	if (soundId >= SoundStorage::Sounds.size())
+		return nullptr;
+
+	return &SoundStorage::Sounds[soundId];
+}
+
+std::uint32_t SoundStorage::SavePath(const std::string_view& path, const SoundLoadMode loadMode)
+{
+	const std::size_t v_pathHash = hash_path(path, loadMode);
+
+	const std::uint32_t v_pathId = SoundStorage::PathIndex.find(v_pathHash);
+	if (v_pathId != SoundStorage::InvalidId)
+		return v_pathId;
+
+	const std::uint32_t v_newPathId = static_cast<std::uint32_t>(SoundStorage::Paths.size());
+	SoundStorage::Paths.push_back(SoundPath{
+		.path = std::string(path),
+		.sound = nullptr,
+		.loadMode = loadMode,
+		.resolvedMode = loadMode,
+		.loadQueued = false,
+		.stamp = {},
+		.bankEntry = nullptr,
+		.generation = SoundStorage::Generation - 1,
+		.duplicateOf = SoundStorage::InvalidId,
+		.contentHash = 0,
+		.hasContentHash = false,
+		.instanceCount = 0,
+		.soundSerial = ++SoundStorage::SoundSerialCounter,
+		.lastUsed = 0,
+		.memoryBytes = 0,
+		.pendingBytes = 0,
+		.lruPrev = SoundStorage::InvalidId,
+		.lruNext = SoundStorage::InvalidId,
+		.inLru = false
+	});
+	SoundStorage::PathIndex.insert(v_pathHash, v_newPathId);
+
+	return v_newPathId;
+}
+
+const std::string& SoundStorage::GetPath(const std::uint32_t pathId)
+{
+	return SoundStorage::Paths[pathId].path;
+}
+
+std::size_t SoundStorage::GetPathKey(const std::uint32_t pathId)
+{
+	const SoundPath& v_path = SoundStorage::Paths[pathId];
+	return hash_path(v_path.path, v_path.loadMode);
+}
+
+void SoundStorage::ValidatePath(const std::uint32_t pathId)
+{
+	SoundPath& v_path = SoundStorage::Paths[pathId];
+	if (v_path.generation == SoundStorage::Generation)
+		return;
+
+	v_path.generation = SoundStorage::Generation;
+
+	File::Stamp v_stamp;
+	if (v_path.bank)
+		v_stamp = File::Stamp{ v_path.bankEntry->dataLength, v_path.bank->stamp().writeTime };
+	else
+		File::GetStamp(v_path.path, v_stamp);
+
+	if (v_path.sound)
+	{
+		if (v_path.stamp == v_stamp)
+		{
+			SoundStorage::ReloadStats.kept++;
+			return;
+		}
+
+		DebugOutL(__FUNCTION__, " -> Sound file has changed: ", v_path.path);
+
+		SoundStorage::RetirePathSound(v_path);
+		SoundStorage::ReloadStats.reloaded++;
+	}
+	else
+	{
+		SoundStorage::ReloadStats.loaded++;
+	}
+
+	if (!(v_path.stamp == v_stamp))
+		v_path.hasContentHash = false;
+
+	v_path.stamp = v_stamp;
+	v_path.resolvedMode = resolve_load_mode(v_path.loadMode, v_stamp);
+}
+
+bool SoundStorage::IsStream(const std::uint32_t pathId)
+{
+	return SoundStorage::Paths[pathId].resolvedMode == SoundLoadMode::Stream;
+}
+
+static bool ensure_content_hash(SoundPath& path)
+{
+	if (path.hasContentHash)
+		return true;
+
+	if (!Hash::File(path.path, path.contentHash))
+		return false;
+
+	path.hasContentHash = true;
+	return true;
+}
+
+std::uint32_t SoundStorage::FindDuplicate(const std::uint32_t pathId)
+{
+	SoundPath& v_path = SoundStorage::Paths[pathId];
+
+	//Every instance opens its own stream, so there is nothing to share
+	if (v_path.resolvedMode == SoundLoadMode::Stream || v_path.stamp.size == 0)
+		return pathId;
+
+	//Only files with the same size can be identical, so most files are never hashed
+	const std::size_t v_sizeKey = hash_content_key(v_path.stamp.size, v_path.resolvedMode);
+	const std::uint32_t v_sameSizeId = SoundStorage::SizeIndex.find(v_sizeKey);
+	if (v_sameSizeId == SoundStorage::InvalidId)
+	{
+		SoundStorage::SizeIndex.insert(v_sizeKey, pathId);
+		return pathId;
+	}
+
+	if (v_sameSizeId == pathId)
+		return pathId;
+
+	SoundPath& v_sameSizePath = SoundStorage::Paths[v_sameSizeId];
+	if (!ensure_content_hash(v_sameSizePath) || !ensure_content_hash(v_path))
+		return pathId;
+
+	SoundStorage::ContentIndex.insert(hash_content_key(v_sameSizePath.contentHash, v_sameSizePath.resolvedMode), v_sameSizeId);
+
+	const std::size_t v_contentKey = hash_content_key(v_path.contentHash, v_path.resolvedMode);
+	const std::uint32_t v_originalId = SoundStorage::ContentIndex.find(v_contentKey);
+	if (v_originalId == SoundStorage::InvalidId)
+	{
+		SoundStorage::ContentIndex.insert(v_contentKey, pathId);
+		return pathId;
+	}
+
+	if (v_originalId == pathId)
+		return pathId;
+
+	if (v_path.duplicateOf == SoundStorage::InvalidId)
+	{
+		DebugOutL(__FUNCTION__, " -> ", v_path.path, " is identical to ", SoundStorage::Paths[v_originalId].path);
+		SoundStorage::ReloadStats.deduplicated++;
+	}
+
+	//The copy might still be loaded and played by instances from the previous world
+	SoundStorage::RetirePathSound(v_path);
+	v_path.duplicateOf = v_originalId;
+
+	return v_originalId;
+}
+
+void SoundStorage::ReleasePathSound(SoundPath& path)
+{
+	if (!path.sound) return;
+
+	lru_unlink(path);
+	drop_pending_load(path);
+
+	SoundLoadQueue::Forget(path.sound);
+	path.sound->release();
+	path.sound = nullptr;
+
+	SoundStorage::ResidentBytes -= path.memoryBytes;
+	path.memoryBytes = 0;
+
+	//Cached sounds point directly into the mapped blob
+	path.mapping.close();
+}
+
+void SoundStorage::RetirePathSound(SoundPath& path)
+{
+	if (!path.sound) return;
+
+	if (path.instanceCount == 0)
+	{
+		SoundStorage::ReleasePathSound(path);
+		return;
+	}
+
+	//The pins move with the sound, the memory stays counted until the sound is released
+	lru_unlink(path);
+	drop_pending_load(path);
+
+	SoundLoadQueue::Forget(path.sound);
+	SoundStorage::RetiredSounds.push_back(RetiredSound{
+		.sound = path.sound,
+		.mapping = std::move(path.mapping),
+		.bank = path.bank,
+		.pathKey = hash_path(path.path, path.loadMode),
+		.soundSerial = path.soundSerial,
+		.instanceCount = path.instanceCount,
+		.memoryBytes = path.memoryBytes
+	});
+
+	path.sound = nullptr;
+	path.memoryBytes = 0;
+	path.instanceCount = 0;
+	path.soundSerial = ++SoundStorage::SoundSerialCounter;
+}
+
+//Bank payloads are handed to FMOD in place, the bank mapping outlives the sound
+static const char* get_sound_source(const SoundPath& path, FMOD_MODE& r_mode, FMOD_CREATESOUNDEXINFO& r_exInfo)
+{
+	if (!path.bank)
+		return path.path.c_str();
+
+	r_mode |= FMOD_OPENMEMORY_POINT;
+	r_exInfo.length = static_cast<unsigned int>(path.bankEntry->dataLength);
+
+	return reinterpret_cast<const char*>(path.bank->data(*path.bankEntry));
+}
+
+FMOD::Sound* SoundStorage::CreateSound(const std::uint32_t pathId)
+{
+	SoundPath& v_path = SoundStorage::Paths[pathId];
+	if (v_path.sound)
+		return v_path.sound;
+
+	if (v_path.resolvedMode == SoundLoadMode::Stream)
+	{
+		DebugErrorL("Streams can't be shared: ", v_path.path);
+		return nullptr;
+	}
+
+	AudioManager* v_pAudioMgr = AudioManager::GetInstance();
+	if (!v_pAudioMgr)
+	{
+		DebugErrorL("AudioManager is not initialized!");
+		return nullptr;
+	}
+
+	//Compressed samples would be decoded to PCM by the cache, bank payloads are already mapped
+	const bool v_useCache = PcmCache::IsEnabled() && v_path.resolvedMode == SoundLoadMode::Sample && !v_path.bank;
+	if (v_useCache)
+	{
+		v_path.sound = PcmCache::CreateSound(v_pAudioMgr->fmod_system, v_path.path, v_path.stamp, v_path.mapping);
+		if (v_path.sound)
+		{
+			DebugOutL(__FUNCTION__, " -> Loaded a cached sound: ", v_path.path);
+			return v_path.sound;
+		}
+	}
+
+	FMOD_MODE v_mode = FMOD_ACCURATETIME | FMOD_NONBLOCKING;
+	if (v_path.resolvedMode == SoundLoadMode::Compressed)
+		v_mode |= FMOD_CREATECOMPRESSEDSAMPLE;
+
+	FMOD_CREATESOUNDEXINFO v_exInfo{};
+	v_exInfo.cbsize = sizeof(v_exInfo);
+	v_exInfo.nonblockcallback = SoundLoadQueue::OnSoundLoaded;
+
+	const char* v_pSource = get_sound_source(v_path, v_mode, v_exInfo);
+
+	FMOD::Sound* v_pCustomSound;
+	if (v_pAudioMgr->fmod_system->createSound(v_pSource, v_mode, &v_exInfo, &v_pCustomSound) != FMOD_OK)
+	{
+		DebugErrorL("Couldn't load the specified sound file: ", v_path.path);
+		return nullptr;
+	}
+
+	if (v_useCache)
+		PcmCache::QueueBuild(v_path.path);
+
+	DebugOutL(__FUNCTION__, " -> Loaded a sound: ", v_path.path);
+	v_path.sound = v_pCustomSound;
+	return v_pCustomSound;
+}
+
+FMOD::Sound* SoundStorage::CreateStream(const std::uint32_t pathId, const FMOD_MODE extraFlags)
+{
+	AudioManager* v_pAudioMgr = AudioManager::GetInstance();
+	if (!v_pAudioMgr)
+	{
+		DebugErrorL("AudioManager is not initialized!");
+		return nullptr;
+	}
+
+	//Opening a stream only reads the header and fills the stream buffer, so it is done synchronously
+	const SoundPath& v_path = SoundStorage::Paths[pathId];
+
+	FMOD_MODE v_mode = FMOD_CREATESTREAM | extraFlags;
+	FMOD_CREATESOUNDEXINFO v_exInfo{};
+	v_exInfo.cbsize = sizeof(v_exInfo);
+
+	const char* v_pSource = get_sound_source(v_path, v_mode, v_exInfo);
+
+	FMOD::Sound* v_pStream;
+	if (v_pAudioMgr->fmod_system->createSound(v_pSource, v_mode, &v_exInfo, &v_pStream) != FMOD_OK)
+	{
+		DebugErrorL("Couldn't open the specified sound stream: ", v_path.path);
+		return nullptr;
+	}
+
+	return v_pStream;
+}
+
+void SoundStorage::PrefetchSound(const std::uint32_t soundId)
+{
+	const SoundData* v_pSoundData = SoundStorage::GetSoundData(soundId);
+	if (!v_pSoundData) return;
+
+	SoundPath& v_path = SoundStorage::Paths[v_pSoundData->pathId];
+	if (v_path.sound || v_path.resolvedMode == SoundLoadMode::Stream) return;
+
+	//Count the prefetch as a use, so the sound is not the first one to be evicted
+	SoundStorage::TouchPath(v_pSoundData->pathId);
+
+	SoundLoadQueue::Request(v_pSoundData->pathId, SoundLoadPriority::High);
+	SoundLoadQueue::Update();
+}
+
+bool SoundStorage::IsSoundReady(FMOD::Sound* sound)
+{
+	FMOD_OPENSTATE v_openState;
+	if (sound->getOpenState(&v_openState, nullptr, nullptr, nullptr) != FMOD_OK)
+		return false;
+
+	return v_openState != FMOD_OPENSTATE_LOADING && v_openState != FMOD_OPENSTATE_ERROR;
+}
+
+FMOD_RESULT SoundStorage::AcquireSound(const SoundData& soundData, FMOD::Sound** r_sound)
+{
+	SoundPath& v_path = SoundStorage::Paths[soundData.pathId];
+	if (v_path.resolvedMode == SoundLoadMode::Stream)
+	{
+		//The stream buffer is filled ahead of the playback, so the loop mode has to be known when the stream is opened
+		const FMOD_MODE v_loopMode = (soundData.effectData.loopCount != 0) ? FMOD_LOOP_NORMAL : 0;
+
+		FMOD::Sound* v_pStream = SoundStorage::CreateStream(soundData.pathId, v_loopMode);
+		if (!v_pStream)
+			return FMOD_ERR_FILE_NOTFOUND;
+
+		v_path.instanceCount++;
+		SoundStorage::TouchPath(soundData.pathId);
+
+		*r_sound = v_pStream;
+		return FMOD_OK;
+	}
+
+	if (!v_path.sound)
+	{
+		SoundLoadQueue::Request(soundData.pathId, SoundLoadPriority::High);
+		SoundLoadQueue::Update();
+
+		if (!v_path.sound)
+		{
+			switch (soundData.loadPolicy)
+			{
+			case SoundLoadPolicy::Queue:
+				//The instance picks the sound up once the queue gets to it
+				v_path.instanceCount++;
+				SoundStorage::TouchPath(soundData.pathId);
+
+				*r_sound = nullptr;
+				return FMOD_OK;
+			case SoundLoadPolicy::Skip:
+				return FMOD_ERR_NOTREADY;
+			default:
+				break;
+			}
+
+			if (!SoundLoadQueue::Start(soundData.pathId))
+				return FMOD_ERR_FILE_NOTFOUND;
+		}
+	}
+
+	FMOD_OPENSTATE v_openState;
+	if (v_path.sound->getOpenState(&v_openState, nullptr, nullptr, nullptr) != FMOD_OK || v_openState == FMOD_OPENSTATE_ERROR)
+	{
+		DebugErrorL("Couldn't load the specified sound file: ", v_path.path);
+		return FMOD_ERR_FILE_BAD;
+	}
+
+	if (v_openState == FMOD_OPENSTATE_LOADING && soundData.loadPolicy != SoundLoadPolicy::Queue)
+	{
+		if (soundData.loadPolicy == SoundLoadPolicy::Skip)
+			return FMOD_ERR_NOTREADY;
+
+		if (!SoundLoadQueue::WaitForLoad(v_path.sound, std::chrono::milliseconds(CAE_SOUND_LOAD_TIMEOUT_MS)))
+		{
+			DebugWarningL("The sound took too long to load: ", v_path.path);
+			return FMOD_ERR_NOTREADY;
+		}
+	}
+
+	v_path.instanceCount++;
+	SoundStorage::TouchPath(soundData.pathId);
+
+	*r_sound = v_path.sound;
+	return FMOD_OK;
+}
+
+std::uint32_t SoundStorage::GetSoundSerial(const std::uint32_t pathId)
+{
+	return SoundStorage::Paths[pathId].soundSerial;
+}
+
+void SoundStorage::ReleaseSound(const std::uint32_t pathId, const std::uint32_t generation, const std::size_t pathKey, const std::uint32_t soundSerial)
+{
+	//Path ids change when the table is compacted on reload
+	const std::uint32_t v_pathId = (generation == SoundStorage::Generation) ? pathId : SoundStorage::PathIndex.find(pathKey);
+	if (v_pathId < SoundStorage::Paths.size())
+	{
+		SoundPath& v_path = SoundStorage::Paths[v_pathId];
+		if (v_path.soundSerial == soundSerial)
+		{
+			if (v_path.instanceCount > 0)
+				v_path.instanceCount--;
+
+			return;
+		}
+	}
+
+	//The sound was retired while the instance was holding it
+	std::vector<RetiredSound>& v_retired = SoundStorage::RetiredSounds;
+	for (std::size_t a = 0; a < v_retired.size(); a++)
+	{
+		RetiredSound& v_sound = v_retired[a];
+		if (v_sound.pathKey != pathKey || v_sound.soundSerial != soundSerial)
+			continue;
+
+		if (--v_sound.instanceCount > 0)
+			return;
+
+		SoundLoadQueue::Forget(v_sound.sound);
+		v_sound.sound->release();
+		SoundStorage::ResidentBytes -= v_sound.memoryBytes;
+
+		v_retired[a] = std::move(v_retired.back());
+		v_retired.pop_back();
+		return;
+	}
+}
+
+void SoundStorage::ReleaseSound(const std::uint32_t pathId)
+{
+	SoundStorage::ReleaseSound(pathId, SoundStorage::Generation, SoundStorage::GetPathKey(pathId), SoundStorage::GetSoundSerial(pathId));
+}
+
+void SoundStorage::TouchPath(const std::uint32_t pathId)
+{
+	SoundPath& v_path = SoundStorage::Paths[pathId];
+	v_path.lastUsed = ++SoundStorage::UseCounter;
+
+	if (v_path.inLru && pathId != SoundStorage::LruTail)
+	{
+		lru_unlink(v_path);
+		lru_push_back(pathId);
+	}
+}
+
+void SoundStorage::AddPendingLoad(const std::uint32_t pathId)
+{
+	SoundPath& v_path = SoundStorage::Paths[pathId];
+	if (v_path.pendingBytes != 0 || v_path.memoryBytes != 0)
+		return;
+
+	//Decoded samples are usually bigger than the file, but the file size is known before the load has started
+	v_path.pendingBytes = v_path.stamp.size;
+	SoundStorage::PendingBytes += v_path.pendingBytes;
+}
+
+void SoundStorage::OnSoundLoaded(const std::uint32_t pathId)
+{
+	SoundPath& v_path = SoundStorage::Paths[pathId];
+	drop_pending_load(v_path);
+
+	if (!v_path.sound || v_path.inLru)
+		return;
+
+	FMOD_OPENSTATE v_openState;
+	if (v_path.sound->getOpenState(&v_openState, nullptr, nullptr, nullptr) != FMOD_OK || v_openState != FMOD_OPENSTATE_READY)
+		return;
+
+	unsigned int v_pcmBytes;
+	if (v_path.sound->getLength(&v_pcmBytes, FMOD_TIMEUNIT_PCMBYTES) != FMOD_OK)
+		return;
+
+	//Compressed samples stay roughly as big as the source file
+	v_path.memoryBytes = (v_path.resolvedMode == SoundLoadMode::Compressed) ? v_path.stamp.size : v_pcmBytes;
+	SoundStorage::ResidentBytes += v_path.memoryBytes;
+
+	lru_push_back(pathId);
+}
+
+void SoundStorage::EnforceMemoryBudget()
+{
+	const std::uint64_t v_budget = AudioSettings::MemoryBudget;
+	if (v_budget == 0) return;
+
+	//Sounds with live instances are skipped, they move to the back of the list once they are played again
+	std::uint32_t v_pathId = SoundStorage::LruHead;
+	while (v_pathId != SoundStorage::InvalidId && SoundStorage::ResidentBytes + SoundStorage::PendingBytes > v_budget)
+	{
+		SoundPath& v_path = SoundStorage::Paths[v_pathId];
+		v_pathId = v_path.lruNext;
+
+		if (v_path.instanceCount > 0)
+			continue;
+
+		DebugOutL(__FUNCTION__, " -> Evicting a sound: ", v_path.path);
+		SoundStorage::ReleasePathSound(v_path);
+	}
+}
+
+void SoundStorage::RegisterSound(
+	const std::string_view& sound_path,
+	const std::string_view& sound_name,
+	const SoundEffectData& effect_data,
+	const SoundLoadPolicy load_policy,
+	const std::uint32_t bus_id)
+{
+	const std::size_t v_nameHash = SoundStorage::HashName(sound_name);
+	if (SoundStorage::NameIndex.find(v_nameHash) != SoundStorage::InvalidId)
+	{
+		DebugWarningL("The specified sound name is already occupied! (", sound_name, ")");
+		return;
+	}
+
+	const std::uint32_t v_pathId = SoundStorage::SavePath(sound_path, effect_data.loadMode);
+	SoundStorage::ValidatePath(v_pathId);
+
+	SoundStorage::AddSound(v_nameHash, sound_name, v_pathId, effect_data, load_policy, bus_id);
+}
+
+std::shared_ptr<const SoundBank> SoundStorage::OpenBank(const std::string& path)
+{
+	File::Stamp v_stamp;
+	if (!File::GetStamp(path, v_stamp))
+	{
+		DebugErrorL("Couldn't find the sound bank: ", path);
+		return nullptr;
+	}
+
+	for (const std::shared_ptr<const SoundBank>& v_bank : SoundStorage::Banks)
+		if (v_bank->path() == path && v_bank->stamp() == v_stamp)
+			return v_bank;
+
+	std::shared_ptr<SoundBank> v_newBank = std::make_shared<SoundBank>();
+	if (!v_newBank->open(path))
+	{
+		DebugErrorL("Couldn't open the sound bank: ", path);
+		return nullptr;
+	}
+
+	SoundStorage::Banks.push_back(v_newBank);
+	return v_newBank;
+}
+
+void SoundStorage::RegisterBank(const std::string& bank_path, const std::uint32_t bus_id)
+{
+	const std::shared_ptr<const SoundBank> v_pBank = SoundStorage::OpenBank(bank_path);
+	if (!v_pBank) return;
+
+	for (std::uint32_t a = 0; a < v_pBank->size(); a++)
+		SoundStorage::RegisterBankSound(v_pBank, v_pBank->entry(a), bus_id);
+
+	DebugOutL(__FUNCTION__, " -> Loaded ", v_pBank->size(), " sounds from: ", bank_path);
+}
+
+void SoundStorage::RegisterBankSound(const std::shared_ptr<const SoundBank>& bank, const SoundBankEntry& entry, const std::uint32_t busId)
+{
+	const std::string_view v_soundName = bank->name(entry);
+	const std::size_t v_nameHash = SoundStorage::HashName(v_soundName);
+	if (SoundStorage::NameIndex.find(v_nameHash) != SoundStorage::InvalidId)
+	{
+		DebugWarningL("The specified sound name is already occupied! (", v_soundName, ")");
+		return;
+	}
+
+	const SoundEffectData v_effectData = bank->effectData(entry);
+
+	//Identical payloads share their offset, so they also share the path
+	const std::string v_virtualPath = bank->path() + "|" + std::to_string(entry.dataOffset);
+	const std::uint32_t v_pathId = SoundStorage::SavePath(v_virtualPath, v_effectData.loadMode);
+
+	SoundPath& v_path = SoundStorage::Paths[v_pathId];
+
+	//A new version of the bank always changes the stamp. The old sound is retired before the bank is swapped,
+	//so a sound that is still pinned keeps the previous version of the bank mapped
+	if (v_path.bank != bank && v_path.sound)
+	{
+		DebugOutL(__FUNCTION__, " -> Sound bank has changed: ", v_path.path);
+		SoundStorage::RetirePathSound(v_path);
+	}
+
+	v_path.bank = bank;
+	v_path.bankEntry = &entry;
+
+	SoundStorage::ValidatePath(v_pathId);
+
+	v_path.contentHash = entry.contentHash;
+	v_path.hasContentHash = true;
+
+	SoundStorage::AddSound(v_nameHash, v_soundName, v_pathId, v_effectData, static_cast<SoundLoadPolicy>(entry.loadPolicy), busId);
+}
+
+void SoundStorage::AddSound(
+	const std::size_t nameHash,
+	const std::string_view& name,
+	std::uint32_t pathId,
+	const SoundEffectData& effectData,
+	const SoundLoadPolicy loadPolicy,
+	const std::uint32_t busId)
+{
+	pathId = SoundStorage::FindDuplicate(pathId);
+
+	//Lazy sounds are loaded on the first lookup instead, streams are opened by every instance
+	if (!AudioSettings::LazyLoading)
+		SoundLoadQueue::Request(pathId, SoundLoadPriority::Low);
+
+	const std::uint32_t v_soundId = static_cast<std::uint32_t>(SoundStorage::Sounds.size());
+	SoundStorage::Sounds.push_back(SoundData{
+		.effectData = effectData,
+		.name = std::string(name),
+		.pathId = pathId,
+		.loadPolicy = loadPolicy,
+		.busId = busId
+	});
+
+	SoundStorage::NameIndex.insert(nameHash, v_soundId);
+}
\ No newline at end of file
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "SoundData.hpp"
+#include "SoundBank.hpp"
+
+#include "Utils/FlatHashIndex.hpp"
+#include "Utils/MappedFile.hpp"
+#include "Utils/File.hpp"
+
+#include <fmod/fmod.hpp>
+
+#include <string_view>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include <cstdint>
+#include <cstddef>
+
+//How long createInstance can block on a sound with SoundLoadPolicy::Wait
+#define CAE_SOUND_LOAD_TIMEOUT_MS 2000
+
+struct SoundPath
+{
+	std::string path;
+	//Shared sound, always nullptr for streams
+	FMOD::Sound* sound;
+	//Load mode from the config, the same file can be registered with several load modes
+	SoundLoadMode loadMode;
+	//Load mode after resolving SoundLoadMode::Auto
+	SoundLoadMode resolvedMode;
+	//Waiting in SoundLoadQueue, the sound is not created yet
+	bool loadQueued;
+	File::Stamp stamp;
+	//Only used by sounds created from the PCM cache
+	MappedFile mapping;
+	//Set for sounds stored in a sound bank, the payload is played from the mapped bank
+	std::shared_ptr<const SoundBank> bank;
+	const SoundBankEntry* bankEntry;
+	//Last reload generation the path was referenced in
+	std::uint32_t generation;
+	//Path with the same file contents that holds the shared sound during the current generation
+	std::uint32_t duplicateOf;
+
+	//Only computed for files that have the same size as another registered file
+	std::uint64_t contentHash;
+	bool hasContentHash;
+
+	//Number of live fake event instances that use the sound, those are never evicted
+	std::uint32_t instanceCount;
+	//Changes every time the path gets a new sound, instances use it to find a sound that was retired while they held it
+	std::uint32_t soundSerial;
+	//Value of SoundStorage::UseCounter when the sound was last played
+	std::uint64_t lastUsed;
+	//Decoded size of the sound, 0 until the sound has finished loading
+	std::uint64_t memoryBytes;
+	//File size of a sound that FMOD is still loading, counted against the memory budget until the decoded size is known
+	std::uint64_t pendingBytes;
+
+	//Loaded sounds are linked from the least to the most recently played one
+	std::uint32_t lruPrev;
+	std::uint32_t lruNext;
+	bool inLru;
+};
+
+//Sound that was replaced or dropped while instances were still using it
+struct RetiredSound
+{
+	FMOD::Sound* sound;
+	MappedFile mapping;
+	std::shared_ptr<const SoundBank> bank;
+	std::size_t pathKey;
+	std::uint32_t soundSerial;
+	std::uint32_t instanceCount;
+	std::uint64_t memoryBytes;
+};
+
+struct SoundReloadStats
+{
+	std::size_t kept = 0;
+	std::size_t loaded = 0;
+	std::size_t reloaded = 0;
+	std::size_t unloaded = 0;
+	std::size_t deduplicated = 0;
+};
+
+//Flat sound registry. Sound ids and path ids are indices into contiguous arrays
+//and stay valid until the next SoundStorage::ClearSounds call
+class SoundStorage
+{
+public:
+	static constexpr std::uint32_t InvalidId = FlatHashIndex::InvalidValue;
+
+	static void ClearSounds();
+	//Drops all the sound names, but keeps the decoded sounds that were referenced during the previous world load.
+	//Sounds are only decoded again if the file size or write time has changed
+	static void BeginReload();
+
+	static std::size_t HashName(const std::string_view& name) noexcept;
+
+	static std::uint32_t FindSoundId(const std::size_t nameHash);
+	static std::uint32_t FindSoundId(const std::string_view& name);
+	static SoundData* GetSoundData(const std::uint32_t soundId);
+
+	static std::uint32_t SavePath(const std::string_view& path, const SoundLoadMode loadMode);
+	static const std::string& GetPath(const std::uint32_t pathId);
+	//Stays valid across reloads as long as the path is kept, unlike the path id
+	static std::size_t GetPathKey(const std::uint32_t pathId);
+	static void ValidatePath(const std::uint32_t pathId);
+	static bool IsStream(const std::uint32_t pathId);
+	//Returns the id of an earlier path with identical file contents and load mode, or the given path id
+	static std::uint32_t FindDuplicate(const std::uint32_t pathId);
+
+	static void ReleasePathSound(SoundPath& path);
+	//Same as SoundStorage::ReleasePathSound, but a sound that is pinned by instances is only released with the last pin
+	static void RetirePathSound(SoundPath& path);
+	//Returns the shared sound of the path. Must not be used on streams
+	static FMOD::Sound* CreateSound(const std::uint32_t pathId);
+	//Opens a new stream that is owned by the caller
+	static FMOD::Sound* CreateStream(const std::uint32_t pathId, const FMOD_MODE extraFlags = 0);
+
+	//Moves the sound to the front of the load queue if it isn't loaded yet
+	static void PrefetchSound(const std::uint32_t soundId);
+	static bool IsSoundReady(FMOD::Sound* sound);
+	//Loads the sound again if it was evicted and pins it until SoundStorage::ReleaseSound is called.
+	//Streams return a new sound that has to be released by the caller.
+	//With SoundLoadPolicy::Queue the returned sound can still be loading or nullptr if the load has not started yet.
+	//Returns FMOD_ERR_NOTREADY if the sound is still loading and its policy is SoundLoadPolicy::Skip
+	static FMOD_RESULT AcquireSound(const SoundData& soundData, FMOD::Sound** r_sound);
+	static std::uint32_t GetSoundSerial(const std::uint32_t pathId);
+	static void ReleaseSound(const std::uint32_t pathId, const std::uint32_t generation, const std::size_t pathKey, const std::uint32_t soundSerial);
+	//Releases a pin that was taken during the current generation
+	static void ReleaseSound(const std::uint32_t pathId);
+	//Marks the sound as the most recently played one
+	static void TouchPath(const std::uint32_t pathId);
+
+	//Counts the file size of the path against the memory budget until SoundStorage::OnSoundLoaded is called
+	static void AddPendingLoad(const std::uint32_t pathId);
+	//Replaces the pending size with the decoded size, must be called once the load of the path's sound has finished
+	static void OnSoundLoaded(const std::uint32_t pathId);
+	//Evicts the least recently played sounds without live instances until the memory budget is met
+	static void EnforceMemoryBudget();
+
+	//Loads the sound right away, unless lazy loading is enabled
+	static void RegisterSound(
+		const std::string_view& sound_path,
+		const std::string_view& sound_name,
+		const SoundEffectData& effect_data,
+		const SoundLoadPolicy load_policy,
+		const std::uint32_t bus_id
+	);
+
+	//Maps the bank once and registers every sound in it
+	static void RegisterBank(const std::string& bank_path, const std::uint32_t bus_id);
+
+private:
+	static std::shared_ptr<const SoundBank> OpenBank(const std::string& path);
+	static void RegisterBankSound(const std::shared_ptr<const SoundBank>& bank, const SoundBankEntry& entry, const std::uint32_t busId);
+	static void AddSound(
+		const std::size_t nameHash,
+		const std::string_view& name,
+		std::uint32_t pathId,
+		const SoundEffectData& effectData,
+		const SoundLoadPolicy loadPolicy,
+		const std::uint32_t busId
+	);
+
+public:
+	inline static std::vector<SoundData> Sounds;
+	inline static std::vector<SoundPath> Paths;
+	inline static std::vector<std::shared_ptr<const SoundBank>> Banks;
+	inline static std::vector<RetiredSound> RetiredSounds;
+
+	inline static FlatHashIndex NameIndex;
+	inline static FlatHashIndex PathIndex;
+	//Only used to find duplicates, cleared on every reload
+	inline static FlatHashIndex SizeIndex;
+	inline static FlatHashIndex ContentIndex;
+
+	inline static std::uint32_t Generation = 0;
+	inline static SoundReloadStats ReloadStats;
+
+	inline static std::uint32_t SoundSerialCounter = 0;
+	inline static std::uint64_t UseCounter = 0;
+	inline static std::uint64_t ResidentBytes = 0;
+	inline static std::uint64_t PendingBytes = 0;
+
+	inline static std::uint32_t LruHead = InvalidId;
+	inline static std::uint32_t LruTail = InvalidId;
+};
\ No newline at end of file
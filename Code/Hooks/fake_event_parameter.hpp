@@ -0,0 +1,126 @@
+#pragma once
+
+#include <string_view>
+
+#include <cstdint>
+
+enum class FakeEventParameter : std::uint8_t
+{
+	Pitch,
+	Volume,
+	Reverb,
+	ReverbIdx,
+	Position,
+	FadeTo,
+	FadeTime,
+	StartDelay,
+	StopDelay,
+	Count
+};
+
+//The parameter names are matched with a switch over the length and the first character of the name
+//after the prefix, so the lookup doesn't hash the name
+inline constexpr FakeEventParameter get_fake_event_parameter(const std::string_view& name) noexcept
+{
+	if (name.size() < 9 || name[3] != '_')
+		return FakeEventParameter::Count;
+
+	//DLM_ is the legacy prefix, it only supports the pitch, volume and reverb parameters
+	const std::string_view v_prefix = name.substr(0, 4);
+	const bool v_isLegacy = (v_prefix == "DLM_");
+	if (!v_isLegacy && v_prefix != "CAE_")
+		return FakeEventParameter::Count;
+
+	const std::string_view v_suffix = name.substr(4);
+	switch (v_suffix.size())
+	{
+	case 5:
+		if (v_suffix == "Pitch")
+			return FakeEventParameter::Pitch;
+
+		break;
+	case 6:
+		switch (v_suffix[0])
+		{
+		case 'F':
+			if (!v_isLegacy && v_suffix == "FadeTo")
+				return FakeEventParameter::FadeTo;
+
+			break;
+		case 'V':
+			if (v_suffix == "Volume")
+				return FakeEventParameter::Volume;
+
+			break;
+		case 'R':
+			if (v_suffix == "Reverb")
+				return FakeEventParameter::Reverb;
+
+			break;
+		}
+
+		break;
+	case 8:
+		if (v_isLegacy) break;
+
+		switch (v_suffix[0])
+		{
+		case 'P':
+			if (v_suffix == "Position")
+				return FakeEventParameter::Position;
+
+			break;
+		case 'F':
+			if (v_suffix == "FadeTime")
+				return FakeEventParameter::FadeTime;
+
+			break;
+		}
+
+		break;
+	case 9:
+		switch (v_suffix[0])
+		{
+		case 'R':
+			if (v_suffix == "ReverbIdx")
+				return FakeEventParameter::ReverbIdx;
+
+			break;
+		case 'S':
+			if (!v_isLegacy && v_suffix == "StopDelay")
+				return FakeEventParameter::StopDelay;
+
+			break;
+		}
+
+		break;
+	case 10:
+		if (!v_isLegacy && v_suffix == "StartDelay")
+			return FakeEventParameter::StartDelay;
+
+		break;
+	}
+
+	return FakeEventParameter::Count;
+}
+
+//Used by the hooks, checks the prefix on the raw string first. The length of the name is only computed
+//for CAE_ and DLM_ names, so most of the foreign names are rejected within the first 4 bytes
+inline constexpr FakeEventParameter get_fake_event_parameter(const char* name) noexcept
+{
+	const bool v_isCae = name[0] == 'C' && name[1] == 'A' && name[2] == 'E';
+	const bool v_isDlm = !v_isCae && name[0] == 'D' && name[1] == 'L' && name[2] == 'M';
+	if ((!v_isCae && !v_isDlm) || name[3] != '_')
+		return FakeEventParameter::Count;
+
+	return get_fake_event_parameter(std::string_view(name));
+}
+
+static_assert(get_fake_event_parameter("CAE_Volume") == FakeEventParameter::Volume);
+static_assert(get_fake_event_parameter("DLM_ReverbIdx") == FakeEventParameter::ReverbIdx);
+static_assert(get_fake_event_parameter("DLM_Position") == FakeEventParameter::Count);
+static_assert(get_fake_event_parameter("CAE_FadeTime") == FakeEventParameter::FadeTime);
+static_assert(get_fake_event_parameter("CAE_StopDelay") == FakeEventParameter::StopDelay);
+static_assert(get_fake_event_parameter("CAE_Volume2") == FakeEventParameter::Count);
+static_assert(get_fake_event_parameter("RPM") == FakeEventParameter::Count);
+static_assert(get_fake_event_parameter("CA") == FakeEventParameter::Count);
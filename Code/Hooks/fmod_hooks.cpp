@@ -1,25 +1,461 @@
 #include "fmod_hooks.hpp"
+#include "fake_event_parameter.hpp"
 
 #include <SmSdk/DirectoryManager.hpp>
 #include <SmSdk/AudioManager.hpp>
-#include <SmSdk/GameSettings.hpp>
 #include <SmSdk/win_include.hpp>
 
+#include "Audio/SoundLoadQueue.hpp"
+#include "Audio/AudioSettings.hpp"
+#include "Audio/SoundMixer.hpp"
+
+#include "Utils/SlabPool.hpp"
 #include "Utils/Console.hpp"
 #include "Utils/File.hpp"
 
 #include <MinHook.h>
 
-#define FAKE_EVENT_CAST(event_name) reinterpret_cast<FakeEventDescription*>(event_name)
+#include <unordered_map>
+#include <string_view>
+#include <algorithm>
+#include <iterator>
+#include <chrono>
+#include <mutex>
+#include <cmath>
+
+#include <climits>
+
+//Fake instances are handed to the game as pool handles, see SlabPool for the layout
+static SlabPool<FakeEventDescription> g_fakeEventPool;
+
+#define IS_FAKE_EVENT(handle) SlabPool<FakeEventDescription>::IsHandle(reinterpret_cast<std::uint64_t>(handle))
+
+//Stale and double released handles are rejected before the instance is touched
+#define FAKE_EVENT_RESOLVE(var_name, handle) \
+	FakeEventDescription* var_name = g_fakeEventPool.get(reinterpret_cast<std::uint64_t>(handle)); \
+	if (!var_name) return FMOD_ERR_INVALID_HANDLE
+
+//Fake event descriptions carry the sound id in bits 0-31 and the SoundStorage generation in bits 32-61.
+//The flag can never be set on a real user space pointer
+#define FAKE_EVENT_DESC_SOUND_ID_FLAG (1ULL << 62)
+#define FAKE_EVENT_DESC_GENERATION_MASK 0x3FFFFFFFULL
+
+#define IS_FAKE_EVENT_DESC(handle) \
+	((reinterpret_cast<std::uintptr_t>(handle) & (3ULL << 62)) == FAKE_EVENT_DESC_SOUND_ID_FLAG)
+
+static FMOD::Studio::EventDescription* encodeSoundId(const std::uint32_t soundId, const std::uint32_t generation = SoundStorage::Generation) noexcept
+{
+	const std::uint64_t v_generation = generation & FAKE_EVENT_DESC_GENERATION_MASK;
+	return reinterpret_cast<FMOD::Studio::EventDescription*>(FAKE_EVENT_DESC_SOUND_ID_FLAG | (v_generation << 32) | soundId);
+}
+
+//Sound ids are only valid until the next reload, descriptions from an earlier world load return SoundStorage::InvalidId
+static std::uint32_t decodeSoundId(const FMOD::Studio::EventDescription* event_desc) noexcept
+{
+	if (!IS_FAKE_EVENT_DESC(event_desc))
+		return SoundStorage::InvalidId;
+
+	const std::uintptr_t v_descValue = reinterpret_cast<std::uintptr_t>(event_desc);
+	if (((v_descValue >> 32) & FAKE_EVENT_DESC_GENERATION_MASK) != (SoundStorage::Generation & FAKE_EVENT_DESC_GENERATION_MASK))
+		return SoundStorage::InvalidId;
+
+	return static_cast<std::uint32_t>(v_descValue);
+}
+
+//DSP clock of the software mixer in samples, keeps running while no channel is playing
+static unsigned long long get_output_clock()
+{
+	AudioManager* v_pAudioMgr = AudioManager::GetInstance();
+	if (!v_pAudioMgr) return 0;
+
+	FMOD::ChannelGroup* v_pMasterGroup;
+	unsigned long long v_dspClock;
+
+	if (v_pAudioMgr->fmod_system->getMasterChannelGroup(&v_pMasterGroup) != FMOD_OK ||
+		v_pMasterGroup->getDSPClock(&v_dspClock, nullptr) != FMOD_OK)
+	{
+		return 0;
+	}
+
+	return v_dspClock;
+}
+
+static double get_output_duration_ms(const unsigned long long samples)
+{
+	AudioManager* v_pAudioMgr = AudioManager::GetInstance();
+	if (!v_pAudioMgr) return 0.0;
+
+	int v_sampleRate;
+	if (v_pAudioMgr->fmod_system->getSoftwareFormat(&v_sampleRate, nullptr, nullptr) != FMOD_OK || v_sampleRate <= 0)
+		return 0.0;
+
+	return static_cast<double>(samples) * 1000.0 / static_cast<double>(v_sampleRate);
+}
+
+//Time of the software mixer
+static double get_output_time_ms()
+{
+	return get_output_duration_ms(get_output_clock());
+}
+
+static unsigned long long get_output_samples(const double timeMs)
+{
+	AudioManager* v_pAudioMgr = AudioManager::GetInstance();
+
+	int v_sampleRate;
+	if (!v_pAudioMgr || v_pAudioMgr->fmod_system->getSoftwareFormat(&v_sampleRate, nullptr, nullptr) != FMOD_OK)
+		return 0;
+
+	return static_cast<unsigned long long>(std::max(timeMs, 0.0) * static_cast<double>(v_sampleRate) / 1000.0);
+}
+
+//Instances with changes that are applied to their channel by the next Studio::System::update
+static std::vector<std::uint64_t> g_dirtyFakeEvents;
+
+static void flush_fake_event_changes()
+{
+	for (const std::uint64_t v_handle : g_dirtyFakeEvents)
+	{
+		FakeEventDescription* v_pFakeEvent = g_fakeEventPool.get(v_handle);
+		if (v_pFakeEvent)
+			v_pFakeEvent->flushChanges();
+	}
+
+	g_dirtyFakeEvents.clear();
+}
+
+//Instances that were created before their sound has finished loading
+static std::vector<FakeEventDescription*> g_waitingFakeEvents;
+
+enum class PendingFakeEventType : std::uint8_t
+{
+	//Sends STARTED or STOPPED if the playback state has changed since the last dispatch
+	StateCheck,
+	//The channel of the instance has ended on its own
+	ChannelEnd,
+	SyncPoint
+};
+
+struct PendingFakeEventCallback
+{
+	std::uint64_t handle;
+	PendingFakeEventType type;
+	//Index of the reached sync point
+	int syncPoint;
+};
+
+//Channel callbacks come from the thread that updates the core system, which is the Studio async thread
+//unless Studio runs in synchronous mode. They are collected here and sent to the game from Studio::System::update
+static std::mutex g_pendingCallbackMutex;
+static std::vector<PendingFakeEventCallback> g_pendingCallbacks;
+
+static void queue_fake_event_callback(const std::uint64_t handle, const PendingFakeEventType type, const int syncPoint = -1)
+{
+	std::lock_guard v_lock(g_pendingCallbackMutex);
+	g_pendingCallbacks.push_back(PendingFakeEventCallback{ handle, type, syncPoint });
+}
+
+static FMOD_RESULT F_CALLBACK on_fake_event_channel_callback(
+	FMOD_CHANNELCONTROL* channel_control,
+	FMOD_CHANNELCONTROL_TYPE control_type,
+	FMOD_CHANNELCONTROL_CALLBACK_TYPE callback_type,
+	void* command_data1,
+	void* /*command_data2*/)
+{
+	if (control_type != FMOD_CHANNELCONTROL_CHANNEL)
+		return FMOD_OK;
+
+	//The channel only carries the pool handle. The instance is never touched on this thread,
+	//the handle is resolved by dispatch_fake_event_callbacks, which drops it if the slot was reused since
+	void* v_pUserData;
+	if (reinterpret_cast<FMOD::Channel*>(channel_control)->getUserData(&v_pUserData) != FMOD_OK || !v_pUserData)
+		return FMOD_OK;
+
+	const std::uint64_t v_handle = reinterpret_cast<std::uint64_t>(v_pUserData);
+	switch (callback_type)
+	{
+	case FMOD_CHANNELCONTROL_CALLBACK_END:
+		queue_fake_event_callback(v_handle, PendingFakeEventType::ChannelEnd);
+		break;
+	case FMOD_CHANNELCONTROL_CALLBACK_SYNCPOINT:
+		queue_fake_event_callback(v_handle, PendingFakeEventType::SyncPoint, static_cast<int>(reinterpret_cast<std::intptr_t>(command_data1)));
+		break;
+	default:
+		break;
+	}
+
+	return FMOD_OK;
+}
+
+//Resolves the handle before every call, the callback is allowed to release the instance
+static void fire_fake_event_callback(const std::uint64_t handle, const FMOD_STUDIO_EVENT_CALLBACK_TYPE type, void* parameters)
+{
+	FakeEventDescription* v_pFakeEvent = g_fakeEventPool.get(handle);
+	if (!v_pFakeEvent || !v_pFakeEvent->m_pCallback || !(v_pFakeEvent->m_callbackMask & type))
+		return;
+
+	v_pFakeEvent->m_pCallback(type, reinterpret_cast<FMOD_STUDIO_EVENTINSTANCE*>(handle), parameters);
+}
+
+static void fire_timeline_marker(const std::uint64_t handle, const int syncPoint)
+{
+	FakeEventDescription* v_pFakeEvent = g_fakeEventPool.get(handle);
+	if (!v_pFakeEvent || !v_pFakeEvent->m_pSound || !(v_pFakeEvent->m_callbackMask & FMOD_STUDIO_EVENT_CALLBACK_TIMELINE_MARKER))
+		return;
+
+	FMOD_SYNCPOINT* v_pSyncPoint;
+	if (v_pFakeEvent->m_pSound->getSyncPoint(syncPoint, &v_pSyncPoint) != FMOD_OK)
+		return;
+
+	char v_name[256] = {};
+	unsigned int v_offsetMs = 0;
+	if (v_pFakeEvent->m_pSound->getSyncPointInfo(v_pSyncPoint, v_name, sizeof(v_name), &v_offsetMs, FMOD_TIMEUNIT_MS) != FMOD_OK)
+		return;
+
+	FMOD_STUDIO_TIMELINE_MARKER_PROPERTIES v_marker{ v_name, static_cast<int>(v_offsetMs) };
+	fire_fake_event_callback(handle, FMOD_STUDIO_EVENT_CALLBACK_TIMELINE_MARKER, &v_marker);
+}
+
+static void check_fake_event_callback_state(const std::uint64_t handle)
+{
+	FakeEventDescription* v_pFakeEvent = g_fakeEventPool.get(handle);
+	if (!v_pFakeEvent) return;
+
+	const bool v_wasStarted = v_pFakeEvent->m_callbackStarted;
+	const bool v_isStarted = v_pFakeEvent->isPlaying();
+	if (v_wasStarted == v_isStarted) return;
+
+	v_pFakeEvent->m_callbackStarted = v_isStarted;
+	if (v_isStarted)
+	{
+		fire_fake_event_callback(handle, FMOD_STUDIO_EVENT_CALLBACK_STARTED, nullptr);
+		return;
+	}
+
+	//The triggers that were merged into this voice have stopped with it
+	if (v_pFakeEvent->m_mergedCount > 1)
+	{
+		g_fakeEventPool.forEach([handle](FakeEventDescription& fake_event) {
+			if (fake_event.m_proxyHandle == handle)
+				fake_event.updateCallbackState();
+		});
+	}
+
+	FMOD::Sound* v_pSound = v_pFakeEvent->m_pSound;
+	fire_fake_event_callback(handle, FMOD_STUDIO_EVENT_CALLBACK_SOUND_STOPPED, v_pSound);
+	fire_fake_event_callback(handle, FMOD_STUDIO_EVENT_CALLBACK_STOPPED, nullptr);
+}
+
+static void dispatch_fake_event_callbacks()
+{
+	std::vector<PendingFakeEventCallback> v_callbacks;
+	{
+		std::lock_guard v_lock(g_pendingCallbackMutex);
+		if (g_pendingCallbacks.empty()) return;
+
+		v_callbacks.swap(g_pendingCallbacks);
+	}
+
+	for (const PendingFakeEventCallback& v_callback : v_callbacks)
+	{
+		switch (v_callback.type)
+		{
+		case PendingFakeEventType::SyncPoint:
+			fire_timeline_marker(v_callback.handle, v_callback.syncPoint);
+			break;
+		case PendingFakeEventType::ChannelEnd:
+		{
+			//Stale handles are dropped, the slot can belong to another instance by now
+			FakeEventDescription* v_pFakeEvent = g_fakeEventPool.get(v_callback.handle);
+			if (!v_pFakeEvent) break;
+
+			v_pFakeEvent->onChannelEnd();
+			check_fake_event_callback_state(v_callback.handle);
+			break;
+		}
+		default:
+			check_fake_event_callback_state(v_callback.handle);
+			break;
+		}
+	}
+}
+
+//Instances that were released while playing and haven't been destroyed yet
+static std::size_t g_releaseRequestedCount = 0;
+static std::uint64_t g_lastLeakCheckMs = 0;
+
+//The handle is invalid afterwards, stale handles are rejected by the pool
+static void destroy_fake_event(const std::uint64_t handle)
+{
+	FakeEventDescription* v_pFakeEvent = g_fakeEventPool.get(handle);
+	if (!v_pFakeEvent) return;
+
+	//Cleared first, so a callback that releases the instance itself doesn't get DESTROYED twice
+	const FMOD_STUDIO_EVENT_CALLBACK v_pCallback = v_pFakeEvent->m_pCallback;
+	v_pFakeEvent->m_pCallback = nullptr;
+
+	if (v_pCallback && (v_pFakeEvent->m_callbackMask & FMOD_STUDIO_EVENT_CALLBACK_DESTROYED))
+	{
+		v_pCallback(FMOD_STUDIO_EVENT_CALLBACK_DESTROYED, reinterpret_cast<FMOD_STUDIO_EVENTINSTANCE*>(handle), nullptr);
+
+		v_pFakeEvent = g_fakeEventPool.get(handle);
+		if (!v_pFakeEvent) return;
+	}
+
+	if (v_pFakeEvent->m_releaseRequested)
+		g_releaseRequestedCount--;
+
+	v_pFakeEvent->release();
+	g_fakeEventPool.destroy(handle);
+}
+
+//A mod that never releases its instances usually leaks the same sound over and over,
+//so the report is grouped by sound and by the content key of the mod that owns the sound
+static void report_leaked_fake_events(const std::vector<const FakeEventDescription*>& leaked)
+{
+	std::unordered_map<std::uint32_t, std::size_t> v_leaksPerSound;
+	std::unordered_map<std::string, std::size_t> v_leaksPerMod;
+	for (const FakeEventDescription* v_pFakeEvent : leaked)
+	{
+		const bool v_isCurrent = v_pFakeEvent->m_generation == SoundStorage::Generation;
+		v_leaksPerSound[v_isCurrent ? v_pFakeEvent->m_soundId : SoundStorage::InvalidId]++;
+
+		//Bus ids stay valid across reloads, so the mod is known even for instances from an earlier world load
+		v_leaksPerMod[SoundMixer::GetModKey(v_pFakeEvent->m_busId)]++;
+	}
+
+	DebugWarningL(leaked.size(), " CAE event instances are still not released after ", AudioSettings::LeakReportSeconds,
+		" seconds, ", g_fakeEventPool.size(), " instances are alive");
+
+	DebugOutL("Leaked instances by sound:");
+	for (const auto& [v_soundId, v_count] : v_leaksPerSound)
+	{
+		const SoundData* v_pSoundData = SoundStorage::GetSoundData(v_soundId);
+		if (!v_pSoundData)
+		{
+			DebugOutL("  <sound from a previous world load>: ", v_count);
+			continue;
+		}
+
+		DebugOutL("  ", v_pSoundData->name, ": ", v_count, " (", SoundStorage::GetPath(v_pSoundData->pathId), ")");
+	}
+
+	DebugOutL("Leaked instances by mod:");
+	for (const auto& [v_modKey, v_count] : v_leaksPerMod)
+		DebugOutL("  ", v_modKey.empty() ? std::string("<unknown mod>") : v_modKey, ": ", v_count);
+}
+
+//Destroys the released instances that have stopped and reports the instances that were never released
+static void reap_fake_events()
+{
+	const std::uint64_t v_nowMs = GetTickCount64();
+	const bool v_checkLeaks = AudioSettings::LeakReportSeconds != 0 && v_nowMs - g_lastLeakCheckMs >= CAE_LEAK_CHECK_INTERVAL_MS;
+	if (g_releaseRequestedCount == 0 && !v_checkLeaks)
+		return;
+
+	if (v_checkLeaks)
+		g_lastLeakCheckMs = v_nowMs;
+
+	const std::uint64_t v_leakAgeMs = std::uint64_t(AudioSettings::LeakReportSeconds) * 1000;
+
+	std::vector<std::uint64_t> v_stoppedHandles;
+	std::vector<const FakeEventDescription*> v_leaked;
+	g_fakeEventPool.forEach([&](FakeEventDescription& fake_event) {
+		if (fake_event.m_releaseRequested)
+		{
+			if (!fake_event.isPlaying() && (!fake_event.m_pCallback || !fake_event.m_callbackStarted))
+				v_stoppedHandles.push_back(fake_event.m_handle);
+
+			return;
+		}
+
+		if (v_checkLeaks && !fake_event.m_leakReported && v_nowMs - fake_event.m_createdMs >= v_leakAgeMs)
+		{
+			fake_event.m_leakReported = true;
+			v_leaked.push_back(&fake_event);
+		}
+	});
+
+	if (!v_leaked.empty())
+		report_leaked_fake_events(v_leaked);
+
+	//The pool can't be changed while it's iterated
+	for (const std::uint64_t v_handle : v_stoppedHandles)
+		destroy_fake_event(v_handle);
+}
+
+//Destroys the oldest stopped instance to make room for a new one, returns false if every instance is playing
+static bool reclaim_fake_event()
+{
+	FakeEventDescription* v_pOldest = nullptr;
+	g_fakeEventPool.forEach([&v_pOldest](FakeEventDescription& fake_event) {
+		if (fake_event.isPlaying() || fake_event.m_waitingForSound)
+			return;
+
+		if (!v_pOldest || fake_event.m_createdMs < v_pOldest->m_createdMs)
+			v_pOldest = &fake_event;
+	});
+
+	if (!v_pOldest) return false;
+
+	const SoundData* v_pSoundData = (v_pOldest->m_generation == SoundStorage::Generation) ? SoundStorage::GetSoundData(v_pOldest->m_soundId) : nullptr;
+	DebugWarningL("Reached the limit of ", CAE_MAX_FAKE_EVENT_INSTANCES, " CAE event instances, destroying an unreleased instance of: ",
+		v_pSoundData ? v_pSoundData->name : std::string("<sound from a previous world load>"));
+
+	destroy_fake_event(v_pOldest->m_handle);
+	return true;
+}
+
+static void update_sound_loads()
+{
+	SoundLoadQueue::Update();
+
+	for (std::size_t a = 0; a < g_waitingFakeEvents.size();)
+	{
+		if (g_waitingFakeEvents[a]->updateWaitingSound())
+		{
+			//Instances whose sound couldn't be loaded stop without ever getting a channel
+			if (!g_waitingFakeEvents[a]->m_hasVoice)
+				g_waitingFakeEvents[a]->m_playbackState = FMOD_STUDIO_PLAYBACK_STOPPED;
+
+			g_waitingFakeEvents[a]->updateCallbackState();
+
+			g_waitingFakeEvents[a] = g_waitingFakeEvents.back();
+			g_waitingFakeEvents.pop_back();
+			continue;
+		}
+
+		a++;
+	}
+}
 
 FakeEventDescription::FakeEventDescription(
 	const SoundData* pSoundData,
+	FMOD::Sound* pSound,
 	FMOD::Channel* pChannel
 ) :
-	m_pSound(pSoundData->sound),
+	m_pSound(pSound),
 	m_pChannel(pChannel),
+	m_soundId(SoundStorage::InvalidId),
+	m_pathId(pSoundData->pathId),
+	m_pathKey(SoundStorage::GetPathKey(pSoundData->pathId)),
+	m_soundSerial(SoundStorage::GetSoundSerial(pSoundData->pathId)),
+	m_busId(pSoundData->busId),
+	m_generation(SoundStorage::Generation),
+	m_ownsSound(SoundStorage::IsStream(pSoundData->pathId)),
 	m_fCustomVolume(1.0f),
 	m_reverbIdx(pSoundData->effectData.reverbIdx),
+	m_coalesceWindowMs(pSoundData->effectData.coalesceWindowMs),
+	m_coalesceVolume(pSoundData->effectData.coalesceVolume),
+	m_coalescePosition(pSoundData->effectData.coalescePosition),
+	m_fadeInMs(pSoundData->effectData.fadeInMs),
+	m_fadeOutMs(pSoundData->effectData.fadeOutMs),
+	m_sequenceIntervalMs(pSoundData->effectData.sequenceIntervalMs),
+	m_sequenceOffsetMs(pSoundData->effectData.sequenceOffsetMs),
+	m_loopCount(pSoundData->effectData.loopCount),
+	m_loopUnit(pSoundData->effectData.loopUnit),
+	m_loopStart(pSoundData->effectData.loopStart),
+	m_loopEnd(pSoundData->effectData.loopEnd),
 	m_fMinDistance(pSoundData->effectData.fMinDistance),
 	m_fMaxDistance(pSoundData->effectData.fMaxDistance),
 	m_is3D(pSoundData->effectData.is3D)
@@ -31,190 +467,839 @@ FMOD_RESULT FakeEventDescription::setVolume(float newVolume)
 	return this->updateVolume();
 }
 
+FMOD_RESULT FakeEventDescription::setPitch(float newPitch)
+{
+	m_fPitch = newPitch;
+	this->markDirty(DirtyPitch);
+
+	return FMOD_OK;
+}
+
 FMOD_RESULT FakeEventDescription::setPosition(float newPosition)
 {
-	return m_pChannel->setPosition(static_cast<std::uint32_t>(newPosition * 1000.0f), FMOD_TIMEUNIT_MS);
+	return this->setTimelinePosition(static_cast<std::uint32_t>(newPosition * 1000.0f));
+}
+
+FMOD_RESULT FakeEventDescription::setTimelinePosition(std::uint32_t newPosition)
+{
+	m_positionMs = newPosition;
+	m_hasPosition = true;
+	if (m_isVirtual)
+		m_virtualStartMs = get_output_time_ms();
+
+	this->markDirty(DirtyPosition);
+	return FMOD_OK;
+}
+
+FMOD_RESULT FakeEventDescription::set3DAttributes(const FMOD_3D_ATTRIBUTES* attributes)
+{
+	m_attributes = *attributes;
+	m_hasAttributes = true;
+	this->markDirty(DirtyAttributes);
+
+	return FMOD_OK;
+}
+
+FMOD_RESULT FakeEventDescription::setReverbLevel(float newLevel)
+{
+	m_fReverbLevel = newLevel;
+	this->markDirty(DirtyReverb);
+
+	return FMOD_OK;
 }
 
 FMOD_RESULT FakeEventDescription::updateVolume()
 {
-	return m_pChannel->setVolume(m_fCustomVolume * GameSettings::GetEffectsVolume());
+	this->markDirty(DirtyVolume);
+	return FMOD_OK;
+}
+
+FMOD_RESULT FakeEventDescription::fadeTo(const float target, const std::uint32_t durationMs, const double delayMs)
+{
+	m_fFadeFrom = this->getFadeLevel();
+	m_fFadeTo = target;
+	m_fadeStartMs = get_output_time_ms() + delayMs;
+	m_fadeDurationMs = durationMs;
+
+	this->markDirty(DirtyFade);
+	return FMOD_OK;
+}
+
+float FakeEventDescription::getFadeLevel() const
+{
+	const double v_elapsedMs = get_output_time_ms() - m_fadeStartMs;
+	if (v_elapsedMs < 0.0)
+		return m_fFadeFrom;
+
+	if (v_elapsedMs >= static_cast<double>(m_fadeDurationMs))
+		return m_fFadeTo;
+
+	const double v_progress = v_elapsedMs / static_cast<double>(m_fadeDurationMs);
+	return m_fFadeFrom + (m_fFadeTo - m_fFadeFrom) * static_cast<float>(v_progress);
+}
+
+double FakeEventDescription::getStartDelayMs() const
+{
+	const unsigned long long v_outputClock = get_output_clock();
+	if (m_startClock <= v_outputClock)
+		return 0.0;
+
+	return get_output_duration_ms(m_startClock - v_outputClock);
+}
+
+static unsigned long long get_scheduled_start_clock(const float startDelay, const std::uint16_t intervalMs, const std::uint16_t offsetMs)
+{
+	if (startDelay <= 0.0f && intervalMs == 0)
+		return 0;
+
+	unsigned long long v_startClock = get_output_clock() + get_output_samples(static_cast<double>(startDelay) * 1000.0);
+	if (intervalMs == 0)
+		return v_startClock;
+
+	//Every sound with the same interval shares the grid, so the starts line up no matter which tick triggered them
+	const unsigned long long v_interval = get_output_samples(static_cast<double>(intervalMs));
+	if (v_interval == 0)
+		return v_startClock;
+
+	const unsigned long long v_offset = get_output_samples(static_cast<double>(offsetMs)) % v_interval;
+	if (v_startClock <= v_offset)
+		return v_offset;
+
+	return (v_startClock - v_offset + v_interval - 1) / v_interval * v_interval + v_offset;
+}
+
+void FakeEventDescription::markDirty(const std::uint8_t flags)
+{
+	//Channels that are created later get the whole state in playSound
+	if (!m_pChannel) return;
+
+	if (m_dirtyFlags == 0)
+		g_dirtyFakeEvents.push_back(m_handle);
+
+	m_dirtyFlags |= flags;
+}
+
+void FakeEventDescription::applyChanges(const std::uint8_t flags)
+{
+	//The effects volume is applied by the CAE channel group
+	if (flags & DirtyVolume)
+		m_pChannel->setVolume(std::max(m_fCustomVolume, m_fMergedVolume) * m_fCoalesceGain);
+
+	if (flags & DirtyPitch)
+		m_pChannel->setPitch(m_fPitch);
+
+	if (flags & DirtyAttributes)
+	{
+		m_pChannel->set3DConeOrientation(&m_attributes.forward);
+		m_pChannel->set3DAttributes(&m_attributes.position, &m_attributes.velocity);
+	}
+
+	if (flags & DirtyReverb)
+	{
+		for (int a = 0; a < 4; a++)
+			m_pChannel->setReverbProperties(a, (m_reverbIdx == a) ? m_fReverbLevel : 0.0f);
+	}
+
+	//The position is only applied once, a restart after a stop or the end of the channel plays from the start again
+	if (flags & DirtyPosition)
+	{
+		m_pChannel->setPosition(m_positionMs, FMOD_TIMEUNIT_MS);
+		m_hasPosition = false;
+	}
+
+	if (flags & DirtyFade)
+		this->applySchedule();
+}
+
+void FakeEventDescription::applySchedule()
+{
+	unsigned long long v_parentClock;
+	if (m_pChannel->getDSPClock(nullptr, &v_parentClock) != FMOD_OK)
+		return;
+
+	//The remaining part of the ramp is rebuilt from the current level, so late flushes don't restart the fade
+	const double v_nowMs = get_output_time_ms();
+	const unsigned long long v_rampStart = v_parentClock + get_output_samples(m_fadeStartMs - v_nowMs);
+	const unsigned long long v_rampEnd = v_parentClock + get_output_samples(m_fadeStartMs + static_cast<double>(m_fadeDurationMs) - v_nowMs);
+
+	m_pChannel->removeFadePoints(0, ULLONG_MAX);
+	m_pChannel->addFadePoint(v_parentClock, this->getFadeLevel());
+	if (v_rampStart > v_parentClock)
+		m_pChannel->addFadePoint(v_rampStart, m_fFadeFrom);
+	if (v_rampEnd > std::max(v_rampStart, v_parentClock))
+		m_pChannel->addFadePoint(v_rampEnd, m_fFadeTo);
+
+	//The parent clock runs in step with the mixer clock, so the scheduled start is moved over by its distance from now
+	const unsigned long long v_outputClock = get_output_clock();
+	const unsigned long long v_startClock = (m_startClock > v_outputClock) ? v_parentClock + (m_startClock - v_outputClock) : 0;
+
+	m_pChannel->setDelay(v_startClock, m_fadingOut ? v_rampEnd : 0, m_fadingOut);
+}
+
+void FakeEventDescription::flushChanges()
+{
+	const std::uint8_t v_flags = m_dirtyFlags;
+	m_dirtyFlags = 0;
+
+	if (m_pChannel && v_flags)
+		this->applyChanges(v_flags);
+}
+
+FMOD_RESULT FakeEventDescription::start()
+{
+	if (m_proxyHandle) return FMOD_OK;
+
+	const bool v_wasStarted = m_startRequested;
+	m_startRequested = true;
+
+	//A stolen instance stays stopped
+	if (!m_stolen)
+		m_playbackState = m_waitingForSound ? FMOD_STUDIO_PLAYBACK_STARTING : FMOD_STUDIO_PLAYBACK_PLAYING;
+
+	this->updateCallbackState();
+
+	if (!v_wasStarted)
+		m_startClock = get_scheduled_start_clock(m_fStartDelay, m_sequenceIntervalMs, m_sequenceOffsetMs);
+
+	//A start during the fade out brings the sound back from its current level
+	if (m_fadingOut)
+	{
+		m_fadingOut = false;
+		this->fadeTo(1.0f, m_fadeInMs);
+	}
+	else if (m_fadeInMs != 0 && !v_wasStarted)
+	{
+		m_fFadeTo = 0.0f;
+		m_fadeDurationMs = 0;
+		this->fadeTo(1.0f, m_fadeInMs, this->getStartDelayMs());
+	}
+	else if (m_startClock != 0)
+	{
+		this->markDirty(DirtyFade);
+	}
+
+	if (m_waitingForSound || m_stolen || m_isVirtual)
+		return FMOD_OK;
+
+	if (m_coalesceWindowMs != 0 && !m_hasVoice)
+		return this->startCoalesced();
+
+	//The previous channel has ended, the instance plays again from the start like a Studio event
+	if (!m_hasVoice)
+	{
+		this->playSound();
+		if (!m_hasVoice)
+			m_playbackState = FMOD_STUDIO_PLAYBACK_STOPPED;
+
+		return FMOD_OK;
+	}
+
+	//The fade and the start delay have to be in place before the channel is unpaused
+	if (m_dirtyFlags & DirtyFade)
+	{
+		m_dirtyFlags &= ~DirtyFade;
+		this->applyChanges(DirtyFade);
+	}
+
+	return m_pChannel->setPaused(false);
+}
+
+FMOD_RESULT FakeEventDescription::stop(const FMOD_STUDIO_STOP_MODE mode)
+{
+	m_startRequested = false;
+
+	//Also drops the position of a virtual voice
+	m_hasPosition = false;
+	m_dirtyFlags &= ~DirtyPosition;
+	this->updateCallbackState();
+
+	//The shared voice keeps playing for the other merged triggers
+	if (m_proxyHandle)
+	{
+		m_proxyHandle = 0;
+		m_playbackState = FMOD_STUDIO_PLAYBACK_STOPPED;
+		return FMOD_OK;
+	}
+
+	if (m_isVirtual)
+	{
+		m_isVirtual = false;
+		m_playbackState = FMOD_STUDIO_PLAYBACK_STOPPED;
+		return FMOD_OK;
+	}
+
+	if (!m_hasVoice)
+	{
+		m_playbackState = FMOD_STUDIO_PLAYBACK_STOPPED;
+		return FMOD_OK;
+	}
+
+	const std::uint32_t v_fadeOutMs = (mode == FMOD_STUDIO_STOP_ALLOWFADEOUT) ? m_fadeOutMs : 0;
+	const double v_stopDelayMs = static_cast<double>(m_fStopDelay) * 1000.0;
+
+	if ((v_fadeOutMs != 0 || v_stopDelayMs > 0.0) && !m_stolen && m_playbackState != FMOD_STUDIO_PLAYBACK_STOPPED)
+	{
+		//The END callback of the channel finishes the stop
+		m_playbackState = FMOD_STUDIO_PLAYBACK_STOPPING;
+		m_fadingOut = true;
+		this->fadeTo(0.0f, v_fadeOutMs, v_stopDelayMs);
+
+		//Applied right away, the flush could come after the game has released the instance
+		m_dirtyFlags &= ~DirtyFade;
+		this->applyChanges(DirtyFade);
+
+		return FMOD_OK;
+	}
+
+	m_fadingOut = false;
+	m_playbackState = FMOD_STUDIO_PLAYBACK_STOPPED;
+	this->detachChannel();
+
+	return m_pChannel->stop();
 }
 
 void FakeEventDescription::updateReverbData()
 {
-	for (int a = 0; a < 4; a++)
-		m_pChannel->setReverbProperties(a, (m_reverbIdx == a) ? 1.0f : 0.0f);
+	this->markDirty(DirtyReverb);
 }
 
 void FakeEventDescription::playSound()
 {
 	AudioManager* v_pAudioMgr = AudioManager::GetInstance();
-	if (!v_pAudioMgr || this->isPlaying()) return;
+	if (!v_pAudioMgr || m_stolen || m_hasVoice) return;
 
-	if (v_pAudioMgr->fmod_system->playSound(m_pSound, nullptr, true, &m_pChannel) != FMOD_OK)
+	//Every path that gives the instance a voice ends up here, also a restart of an instance whose channel has ended
+	if (!this->reserveVoice()) return;
+
+	if (v_pAudioMgr->fmod_system->playSound(m_pSound, SoundMixer::GetGroup(m_busId), true, &m_pChannel) != FMOD_OK)
 		return;
 
-	m_pChannel->setVolume(GameSettings::GetEffectsVolume());
+	m_hasVoice = true;
+
 	m_pChannel->set3DMinMaxDistance(m_fMinDistance, m_fMaxDistance);
 	m_pChannel->set3DDistanceFilter(false, 1.0f, 10000.0f);
 
-	if (m_is3D)
-		m_pChannel->setMode(FMOD_3D);
+	FMOD_MODE v_mode = m_is3D ? FMOD_3D : 0;
+	if (m_loopCount != 0)
+		v_mode |= FMOD_LOOP_NORMAL;
+
+	if (v_mode != 0)
+		m_pChannel->setMode(v_mode);
 
-	this->updateReverbData();
+	//The sounds are shared between instances, so the loop is set up on the channel
+	if (m_loopCount != 0)
+	{
+		m_pChannel->setLoopCount(m_loopCount);
+
+		if (m_loopEnd != 0 || m_loopStart != 0)
+		{
+			const FMOD_TIMEUNIT v_unit = (m_loopUnit == SoundLoopUnit::Samples) ? FMOD_TIMEUNIT_PCM : FMOD_TIMEUNIT_MS;
+
+			//Loop ends are inclusive in FMOD
+			std::uint32_t v_loopEnd = m_loopEnd;
+			if (v_loopEnd == 0)
+				m_pSound->getLength(&v_loopEnd, v_unit);
+
+			if (v_loopEnd > m_loopStart)
+				m_pChannel->setLoopPoints(m_loopStart, v_unit, v_loopEnd - 1, v_unit);
+		}
+	}
+
+	//Apply the state that was set while the sound was loading, the channel is paused so it can't wait for the flush
+	std::uint8_t v_flags = DirtyVolume | DirtyReverb;
+	if (m_fPitch != 1.0f) v_flags |= DirtyPitch;
+	if (m_hasAttributes) v_flags |= DirtyAttributes;
+	if (m_hasPosition) v_flags |= DirtyPosition;
+	if (m_fadeDurationMs != 0 || m_fFadeTo != 1.0f || m_startClock != 0) v_flags |= DirtyFade;
+
+	m_dirtyFlags = 0;
+	this->applyChanges(v_flags);
+	this->attachChannelCallback();
+
+	if (m_startRequested)
+	{
+		m_playbackState = m_fadingOut ? FMOD_STUDIO_PLAYBACK_STOPPING : FMOD_STUDIO_PLAYBACK_PLAYING;
+		m_pChannel->setPaused(false);
+	}
 }
 
-bool FakeEventDescription::isPlaying() const
+void FakeEventDescription::attachChannelCallback()
+{
+	m_pChannel->setUserData(reinterpret_cast<void*>(m_handle));
+	m_pChannel->setCallback(on_fake_event_channel_callback);
+}
+
+void FakeEventDescription::detachChannel()
 {
-	if (!m_pChannel) return false;
+	m_hasVoice = false;
+	if (!m_pChannel) return;
+
+	m_pChannel->setCallback(nullptr);
+	m_pChannel->setUserData(nullptr);
+}
 
+void FakeEventDescription::onChannelEnd()
+{
+	//The END can belong to an earlier channel of the instance that ended before the instance was started again
 	bool v_isPlaying = false;
-	m_pChannel->isPlaying(&v_isPlaying);
+	if (m_hasVoice && m_pChannel->isPlaying(&v_isPlaying) == FMOD_OK && v_isPlaying)
+		return;
 
-	return v_isPlaying;
+	m_hasVoice = false;
+	m_playbackState = FMOD_STUDIO_PLAYBACK_STOPPED;
 }
 
-bool FakeEventDescription::isValidHook() const noexcept
+void FakeEventDescription::updateCallbackState()
 {
-	return (reinterpret_cast<std::uintptr_t>(this) & (1ull << 63));
+	if (m_pCallback)
+		queue_fake_event_callback(m_handle, PendingFakeEventType::StateCheck);
 }
 
-FakeEventDescription* FakeEventDescription::encodePointer() noexcept
+bool FakeEventDescription::updateWaitingSound()
 {
-	const std::uintptr_t v_encodedPtr = reinterpret_cast<std::uintptr_t>(this) | (1ULL << 63);
-	return reinterpret_cast<FakeEventDescription*>(v_encodedPtr);
+	//The sound belongs to the previous world
+	if (m_generation != SoundStorage::Generation)
+	{
+		m_waitingForSound = false;
+		return true;
+	}
+
+	const SoundPath& v_path = SoundStorage::Paths[m_pathId];
+	if (!v_path.sound)
+	{
+		//The sound couldn't be created, the instance stays silent
+		m_waitingForSound = v_path.loadQueued;
+		return !m_waitingForSound;
+	}
+
+	FMOD_OPENSTATE v_openState;
+	if (v_path.sound->getOpenState(&v_openState, nullptr, nullptr, nullptr) != FMOD_OK || v_openState == FMOD_OPENSTATE_ERROR)
+	{
+		m_waitingForSound = false;
+		return true;
+	}
+
+	if (v_openState == FMOD_OPENSTATE_LOADING)
+		return false;
+
+	m_waitingForSound = false;
+	m_pSound = v_path.sound;
+
+	//Same as createInstance and start, so the instances that waited for the same sound are coalesced as well
+	if (m_coalesceWindowMs == 0)
+		this->playSound();
+	else if (m_startRequested)
+		this->startCoalesced();
+
+	return true;
 }
 
-FakeEventDescription* FakeEventDescription::decodePointer() noexcept
+FMOD_STUDIO_PLAYBACK_STATE FakeEventDescription::getPlaybackState() const
 {
-	const std::uintptr_t v_decodedPtr = reinterpret_cast<std::uintptr_t>(this) & ~(1ULL << 63);
-	return reinterpret_cast<FakeEventDescription*>(v_decodedPtr);
+	//Merged triggers follow the shared voice
+	if (m_proxyHandle)
+	{
+		const FakeEventDescription* v_pVoice = g_fakeEventPool.get(m_proxyHandle);
+		return v_pVoice ? v_pVoice->m_playbackState : FMOD_STUDIO_PLAYBACK_STOPPED;
+	}
+
+	return m_playbackState;
 }
 
-FMOD_RESULT FakeEventDescription::release()
+bool FakeEventDescription::isPlaying() const
+{
+	return this->getPlaybackState() != FMOD_STUDIO_PLAYBACK_STOPPED;
+}
+
+bool FakeEventDescription::isActive() const
+{
+	if (m_stolen || m_proxyHandle) return false;
+
+	//Instances that weren't started yet hold a paused channel
+	return m_waitingForSound || m_hasVoice || this->isPlaying();
+}
+
+float FakeEventDescription::getAudibility() const
+{
+	float v_audibility;
+	if (m_pChannel && m_pChannel->getAudibility(&v_audibility) == FMOD_OK)
+		return v_audibility;
+
+	//Waiting instances are not attenuated yet
+	return m_fCustomVolume;
+}
+
+float FakeEventDescription::getDistanceSq(const FMOD_VECTOR& listenerPos) const
+{
+	if (!m_is3D) return 0.0f;
+
+	const FMOD_VECTOR& v_pos = m_attributes.position;
+	const float v_dx = v_pos.x - listenerPos.x;
+	const float v_dy = v_pos.y - listenerPos.y;
+	const float v_dz = v_pos.z - listenerPos.z;
+
+	return v_dx * v_dx + v_dy * v_dy + v_dz * v_dz;
+}
+
+void FakeEventDescription::steal()
+{
+	m_stolen = true;
+	this->stop();
+}
+
+static bool counts_against_limit(const FakeEventDescription* pFakeEvent, const FakeEventDescription* pRequester)
+{
+	return pFakeEvent && pFakeEvent != pRequester && pFakeEvent->isActive();
+}
+
+static FakeEventDescription* pick_stolen_instance(const SoundData& soundData, const FakeEventDescription* pRequester)
+{
+	const std::vector<std::uint64_t>& v_instances = soundData.liveInstances;
+
+	FMOD_VECTOR v_listenerPos = {};
+	if (soundData.effectData.stealMode == SoundStealMode::Furthest)
+	{
+		AudioManager* v_pAudioMgr = AudioManager::GetInstance();
+		if (v_pAudioMgr)
+			v_pAudioMgr->fmod_system->get3DListenerAttributes(0, &v_listenerPos, nullptr, nullptr, nullptr);
+	}
+
+	//Ties go to the oldest instance
+	FakeEventDescription* v_pVictim = nullptr;
+	float v_victimScore = 0.0f;
+
+	for (const std::uint64_t v_handle : v_instances)
+	{
+		FakeEventDescription* v_pFakeEvent = g_fakeEventPool.get(v_handle);
+		if (!counts_against_limit(v_pFakeEvent, pRequester))
+			continue;
+
+		if (soundData.effectData.stealMode == SoundStealMode::Oldest)
+			return v_pFakeEvent;
+
+		const float v_score = (soundData.effectData.stealMode == SoundStealMode::Quietest)
+			? -v_pFakeEvent->getAudibility()
+			: v_pFakeEvent->getDistanceSq(v_listenerPos);
+
+		if (!v_pVictim || v_score > v_victimScore)
+		{
+			v_pVictim = v_pFakeEvent;
+			v_victimScore = v_score;
+		}
+	}
+
+	return v_pVictim;
+}
+
+//Returns false if the sound is at its instance limit and nothing can be stolen.
+//The requester is the instance that is about to get a voice, it is neither counted nor stolen
+static bool enforce_instance_limit(const SoundData& soundData, const FakeEventDescription* pRequester = nullptr)
+{
+	const std::uint16_t v_maxInstances = soundData.effectData.maxInstances;
+	if (v_maxInstances == 0) return true;
+
+	for (;;)
+	{
+		//Instances that have finished playing or were merged into another voice don't hold a slot
+		std::size_t v_activeCount = 0;
+		for (const std::uint64_t v_handle : soundData.liveInstances)
+			if (counts_against_limit(g_fakeEventPool.get(v_handle), pRequester))
+				v_activeCount++;
+
+		if (v_activeCount < v_maxInstances)
+			return true;
+
+		if (soundData.effectData.stealMode == SoundStealMode::None)
+			return false;
+
+		pick_stolen_instance(soundData, pRequester)->steal();
+	}
+}
+
+bool FakeEventDescription::reserveVoice()
+{
+	const SoundData* v_pSoundData = (m_generation == SoundStorage::Generation) ? SoundStorage::GetSoundData(m_soundId) : nullptr;
+	return !v_pSoundData || enforce_instance_limit(*v_pSoundData, this);
+}
+
+static float get_coalesce_gain(const SoundCoalesceVolume curve, const std::uint32_t count)
 {
-	delete this;
-	return FMOD_OK;/*return m_pSound->release();*/
+	switch (curve)
+	{
+	case SoundCoalesceVolume::Constant:
+		return 1.0f;
+	case SoundCoalesceVolume::Log:
+		return 1.0f + std::log2(static_cast<float>(count));
+	case SoundCoalesceVolume::Linear:
+		return static_cast<float>(count);
+	default:
+		return std::sqrt(static_cast<float>(count));
+	}
+}
+
+static bool get_listener_position(FMOD_VECTOR& r_position)
+{
+	AudioManager* v_pAudioMgr = AudioManager::GetInstance();
+	if (!v_pAudioMgr) return false;
+
+	return v_pAudioMgr->fmod_system->get3DListenerAttributes(0, &r_position, nullptr, nullptr, nullptr) == FMOD_OK;
+}
+
+FMOD_RESULT FakeEventDescription::startCoalesced()
+{
+	SoundData* v_pSoundData = (m_generation == SoundStorage::Generation) ? SoundStorage::GetSoundData(m_soundId) : nullptr;
+	if (v_pSoundData)
+	{
+		const double v_nowMs = std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+
+		FakeEventDescription* v_pVoice = g_fakeEventPool.get(v_pSoundData->coalesceLeader);
+		if (v_pVoice && v_pVoice != this && v_pVoice->isPlaying() &&
+			v_nowMs - v_pSoundData->coalesceStartMs <= static_cast<double>(m_coalesceWindowMs))
+		{
+			v_pVoice->mergeTrigger(*this);
+			m_proxyHandle = v_pSoundData->coalesceLeader;
+
+			return FMOD_OK;
+		}
+
+		v_pSoundData->coalesceLeader = m_handle;
+		v_pSoundData->coalesceStartMs = v_nowMs;
+	}
+
+	//A new window starts, the triggers merged into an earlier start of this voice don't count anymore
+	m_mergedCount = 1;
+	m_fCoalesceGain = 1.0f;
+	m_fMergedVolume = 0.0f;
+	m_fLoudestTrigger = m_fCustomVolume;
+	this->playSound();
+
+	//The sound is at its instance limit and nothing could be stolen
+	if (!m_hasVoice)
+		m_playbackState = FMOD_STUDIO_PLAYBACK_STOPPED;
+
+	return FMOD_OK;
 }
 
-///////////////// SOUND STORAGE ////////////////////
+void FakeEventDescription::mergeTrigger(const FakeEventDescription& trigger)
+{
+	m_mergedCount++;
+	m_fCoalesceGain = get_coalesce_gain(m_coalesceVolume, m_mergedCount);
+
+	bool v_useTriggerPosition = false;
+	if (m_coalescePosition == SoundCoalescePosition::Loudest)
+	{
+		v_useTriggerPosition = trigger.m_fCustomVolume > m_fLoudestTrigger;
+	}
+	else
+	{
+		FMOD_VECTOR v_listenerPos;
+		v_useTriggerPosition = get_listener_position(v_listenerPos) &&
+			trigger.getDistanceSq(v_listenerPos) < this->getDistanceSq(v_listenerPos);
+	}
+
+	if (v_useTriggerPosition && trigger.m_hasAttributes)
+	{
+		m_fLoudestTrigger = trigger.m_fCustomVolume;
+		this->set3DAttributes(&trigger.m_attributes);
+	}
+
+	//The voice plays as loud as its loudest trigger
+	m_fMergedVolume = std::max(m_fMergedVolume, trigger.m_fCustomVolume);
+	this->updateVolume();
+}
+
+void FakeEventDescription::updateVirtualVoice(const FMOD_VECTOR& listenerPos)
+{
+	if (!m_is3D || !m_startRequested || m_waitingForSound || m_stolen || m_proxyHandle || !m_pSound)
+		return;
+
+	const float v_distanceSq = this->getDistanceSq(listenerPos);
+	if (m_isVirtual)
+	{
+		//The sound has finished while nobody could hear it, virtual instances have no channel that could report their end
+		std::uint32_t v_position;
+		if (!this->getVirtualPosition(v_position))
+		{
+			m_isVirtual = false;
+			m_hasPosition = false;
+			m_startRequested = false;
+			m_playbackState = FMOD_STUDIO_PLAYBACK_STOPPED;
+			this->updateCallbackState();
+			return;
+		}
+
+		if (v_distanceSq > m_fMaxDistance * m_fMaxDistance)
+			return;
+
+		m_isVirtual = false;
+		m_positionMs = v_position;
+		m_hasPosition = true;
+		this->playSound();
+
+		return;
+	}
+
+	const float v_virtualDistance = m_fMaxDistance * CAE_VIRTUAL_VOICE_MARGIN;
+	if (v_distanceSq <= v_virtualDistance * v_virtualDistance || !m_hasVoice)
+		return;
+
+	bool v_isPaused = false;
+	if (m_pChannel->getPaused(&v_isPaused) != FMOD_OK || v_isPaused)
+		return;
+
+	//The channel position doesn't move before the scheduled start
+	if (m_startClock > get_output_clock())
+		return;
 
-void SoundStorage::ClearSounds()
-{
-	for (auto& [v_soundHash, v_pSound] : SoundStorage::PathHashToSound)
-		v_pSound->release();
+	std::uint32_t v_position;
+	if (m_pChannel->getPosition(&v_position, FMOD_TIMEUNIT_MS) != FMOD_OK)
+		return;
 
-	SoundStorage::PathHashToSound.clear();
-	SoundStorage::NameHashToSound.clear();
+	m_positionMs = v_position;
+	m_hasPosition = true;
+	m_virtualStartMs = get_output_time_ms();
 
-	SoundStorage::HashToPath.clear();
+	this->detachChannel();
+	m_pChannel->stop();
+	m_pChannel = nullptr;
+	m_isVirtual = true;
 }
 
-bool SoundStorage::SoundExists(const std::size_t nameHash)
+bool FakeEventDescription::getVirtualPosition(std::uint32_t& r_position) const
 {
-	return SoundStorage::NameHashToSound.contains(nameHash);
-}
+	const double v_elapsedMs = (get_output_time_ms() - m_virtualStartMs) * m_fPitch;
+	std::uint64_t v_position = m_positionMs + static_cast<std::uint64_t>(std::max(v_elapsedMs, 0.0));
 
-SoundData* SoundStorage::GetSoundData(const std::size_t nameHash)
-{
-	auto v_iter = SoundStorage::NameHashToSound.find(nameHash);
-	if (v_iter != SoundStorage::NameHashToSound.end())
-		return &v_iter->second;
-	else
-		return nullptr;
-}
+	std::uint32_t v_lengthMs = 0;
+	if (!m_pSound || m_pSound->getLength(&v_lengthMs, FMOD_TIMEUNIT_MS) != FMOD_OK || v_lengthMs == 0)
+	{
+		r_position = m_positionMs;
+		return true;
+	}
 
-std::size_t SoundStorage::SavePath(const std::string_view& path)
-{
-	const std::size_t v_stringHash = std::hash<std::string_view>{}(path);
+	FMOD_MODE v_mode = 0;
+	m_pSound->getMode(&v_mode);
 
-	auto v_iter = SoundStorage::HashToPath.find(v_stringHash);
-	if (v_iter != SoundStorage::HashToPath.end())
-		return v_stringHash;
+	std::int32_t v_loopCount = m_loopCount;
+	if (v_loopCount == 0 && (v_mode & FMOD_LOOP_NORMAL))
+		v_loopCount = -1;
 
-	SoundStorage::HashToPath.emplace(v_stringHash, path);
-	return v_stringHash;
-}
+	std::uint32_t v_loopStartMs, v_loopEndMs;
+	this->getLoopRegionMs(v_lengthMs, v_loopStartMs, v_loopEndMs);
 
-bool SoundStorage::GetPath(const std::size_t hash, std::string& outPath)
-{
-	auto v_iter = SoundStorage::HashToPath.find(hash);
-	if (v_iter == SoundStorage::HashToPath.end())
+	if (v_loopCount != 0 && v_position >= v_loopEndMs)
+	{
+		//The loops that were played before the instance went virtual are not known, so the count starts over
+		const std::uint64_t v_loopLengthMs = v_loopEndMs - v_loopStartMs;
+		const std::uint64_t v_loopsPlayed = (v_position - v_loopEndMs) / v_loopLengthMs + 1;
+
+		if (v_loopCount < 0 || v_loopsPlayed <= static_cast<std::uint64_t>(v_loopCount))
+			v_position = v_loopStartMs + (v_position - v_loopEndMs) % v_loopLengthMs;
+		else
+			v_position -= static_cast<std::uint64_t>(v_loopCount) * v_loopLengthMs;
+	}
+
+	if (v_position >= v_lengthMs)
+	{
+		r_position = v_lengthMs;
 		return false;
+	}
 
-	outPath = v_iter->second;
+	r_position = static_cast<std::uint32_t>(v_position);
 	return true;
 }
 
-FMOD::Sound* SoundStorage::CreateSound(const std::string_view& path)
+void FakeEventDescription::getLoopRegionMs(const std::uint32_t lengthMs, std::uint32_t& r_start, std::uint32_t& r_end) const
 {
-	const std::size_t v_hash = std::hash<std::string_view>{}(path);
+	r_start = 0;
+	r_end = lengthMs;
 
-	auto v_iter = SoundStorage::PathHashToSound.find(v_hash);
-	if (v_iter != SoundStorage::PathHashToSound.end())
-		return v_iter->second;
+	if (m_loopStart == 0 && m_loopEnd == 0)
+		return;
 
-	AudioManager* v_pAudioMgr = AudioManager::GetInstance();
-	if (!v_pAudioMgr)
+	double v_toMs = 1.0;
+	if (m_loopUnit == SoundLoopUnit::Samples)
 	{
-		DebugErrorL("AudioManager is not initialized!");
-		return nullptr;
+		float v_frequency = 0.0f;
+		if (m_pSound->getDefaults(&v_frequency, nullptr) != FMOD_OK || v_frequency <= 0.0f)
+			return;
+
+		v_toMs = 1000.0 / static_cast<double>(v_frequency);
 	}
 
-	FMOD::Sound* v_pCustomSound;
-	if (v_pAudioMgr->fmod_system->createSound(path.data(), FMOD_ACCURATETIME | FMOD_NONBLOCKING, nullptr, &v_pCustomSound) != FMOD_OK)
+	r_start = std::min(static_cast<std::uint32_t>(m_loopStart * v_toMs), lengthMs);
+	if (m_loopEnd != 0)
+		r_end = std::min(static_cast<std::uint32_t>(m_loopEnd * v_toMs), lengthMs);
+
+	//An empty region would never advance
+	if (r_end <= r_start)
 	{
-		DebugErrorL("Couldn't load the specified sound file: ", path);
-		return nullptr;
+		r_start = 0;
+		r_end = lengthMs;
 	}
-
-	DebugOutL(__FUNCTION__, " -> Loaded a sound: ", path);
-	SoundStorage::PathHashToSound.emplace(v_hash, v_pCustomSound);
-	return v_pCustomSound;
 }
 
-void SoundStorage::PreloadSound(
-	const std::string_view& sound_path,
-	const std::string_view& sound_name,
-	const SoundEffectData& effect_data)
+FMOD_RESULT FakeEventDescription::release()
 {
-	FMOD::Sound* v_pSound = SoundStorage::CreateSound(sound_path);
-	if (!v_pSound) return;
-	
-	const std::size_t v_nameHash = std::hash<std::string_view>{}(sound_name);
+	if (m_waitingForSound)
+		std::erase(g_waitingFakeEvents, this);
 
-	auto v_name_iter = SoundStorage::NameHashToSound.find(v_nameHash);
-	if (v_name_iter != SoundStorage::NameHashToSound.end())
+	if (m_generation == SoundStorage::Generation)
 	{
-		DebugWarningL("The specified sound name is already occupied! (", sound_name, ")");
-		return;
+		SoundData* v_pSoundData = SoundStorage::GetSoundData(m_soundId);
+		if (v_pSoundData)
+			std::erase(v_pSoundData->liveInstances, m_handle);
 	}
 
-	SoundStorage::NameHashToSound.emplace(v_nameHash, SoundData{
-		.sound = v_pSound,
-		.effectData = effect_data
-	});
+	SoundStorage::ReleaseSound(m_pathId, m_generation, m_pathKey, m_soundSerial);
+
+	//Instances are only released once they have stopped, this also frees the paused channel of an instance that was never started
+	this->detachChannel();
+	if (m_pChannel)
+		m_pChannel->stop();
+
+	//Releasing the stream also stops the channel that plays it
+	if (m_ownsSound)
+		m_pSound->release();
+
+	return FMOD_OK;
 }
 
 ///////////////////// FMOD HOOKS ///////////////////
 
 FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_release(FMOD::Studio::EventInstance* event_instance)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_instance);
-	if (v_pFakeEvent->isValidHook())
-		return v_pFakeEvent->decodePointer()->release();
+	if (IS_FAKE_EVENT(event_instance))
+	{
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+
+		//Same as Studio, a playing instance is destroyed by reap_fake_events once it has stopped
+		if (v_pFakeEvent->isPlaying())
+		{
+			if (!v_pFakeEvent->m_releaseRequested)
+			{
+				v_pFakeEvent->m_releaseRequested = true;
+				g_releaseRequestedCount++;
+			}
+
+			return FMOD_OK;
+		}
+
+		destroy_fake_event(reinterpret_cast<std::uint64_t>(event_instance));
+		return FMOD_OK;
+	}
 
 	return FMODHooks::o_FMOD_Studio_EventInstance_release(event_instance);
 }
 
 FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_start(FMOD::Studio::EventInstance* event_instance)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_instance);
-	if (v_pFakeEvent->isValidHook())
+	if (IS_FAKE_EVENT(event_instance))
 	{
-		v_pFakeEvent->decodePointer()->m_pChannel->setPaused(false);
-		return FMOD_OK;
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		update_sound_loads();
+		return v_pFakeEvent->start();
 	}
 
 	return FMODHooks::o_FMOD_Studio_EventInstance_start(event_instance);
@@ -224,18 +1309,10 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_stop(
 	FMOD::Studio::EventInstance* event_instance,
 	FMOD_STUDIO_STOP_MODE mode)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_instance);
-	if (v_pFakeEvent->isValidHook())
+	if (IS_FAKE_EVENT(event_instance))
 	{
-		v_pFakeEvent = v_pFakeEvent->decodePointer();
-
-		bool v_isPlaying = false;
-		v_pFakeEvent->m_pChannel->isPlaying(&v_isPlaying);
-
-		if (v_isPlaying)
-			return v_pFakeEvent->m_pChannel->stop();
-
-		return FMOD_OK;
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		return v_pFakeEvent->stop(mode);
 	}
 
 	return FMODHooks::o_FMOD_Studio_EventInstance_stop(event_instance, mode);
@@ -245,10 +1322,14 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_get3DAttributes(
 	FMOD::Studio::EventInstance* event_instance,
 	FMOD_3D_ATTRIBUTES* attributes)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_instance);
-	if (v_pFakeEvent->isValidHook())
+	if (IS_FAKE_EVENT(event_instance))
 	{
-		v_pFakeEvent = v_pFakeEvent->decodePointer();
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		if (!v_pFakeEvent->m_pChannel || (v_pFakeEvent->m_dirtyFlags & FakeEventDescription::DirtyAttributes))
+		{
+			*attributes = v_pFakeEvent->m_attributes;
+			return FMOD_OK;
+		}
 
 		v_pFakeEvent->m_pChannel->get3DConeOrientation(&attributes->forward);
 		v_pFakeEvent->m_pChannel->get3DAttributes(&attributes->position, &attributes->velocity);
@@ -264,15 +1345,10 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_set3DAttributes(
 	FMOD::Studio::EventInstance* event_instance,
 	const FMOD_3D_ATTRIBUTES* attributes)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_instance);
-	if (v_pFakeEvent->isValidHook())
+	if (IS_FAKE_EVENT(event_instance))
 	{
-		v_pFakeEvent = v_pFakeEvent->decodePointer();
-
-		FMOD_VECTOR v_forward_cpy = attributes->forward;
-		v_pFakeEvent->m_pChannel->set3DConeOrientation(&v_forward_cpy);
-
-		return v_pFakeEvent->m_pChannel->set3DAttributes(&attributes->position, &attributes->velocity);
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		return v_pFakeEvent->set3DAttributes(attributes);
 	}
 
 	return FMODHooks::o_FMOD_Studio_EventInstance_set3DAttributes(event_instance, attributes);
@@ -283,10 +1359,19 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_getVolume(
 	float* volume,
 	float* final_volume)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_instance);
-	if (v_pFakeEvent->isValidHook())
+	if (IS_FAKE_EVENT(event_instance))
 	{
-		FMOD_RESULT v_result = v_pFakeEvent->decodePointer()->m_pChannel->getVolume(volume);
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		if (!v_pFakeEvent->m_pChannel || (v_pFakeEvent->m_dirtyFlags & FakeEventDescription::DirtyVolume))
+		{
+			*volume = v_pFakeEvent->m_fCustomVolume;
+			if (final_volume)
+				*final_volume = *volume;
+
+			return FMOD_OK;
+		}
+
+		FMOD_RESULT v_result = v_pFakeEvent->m_pChannel->getVolume(volume);
 		if (v_result == FMOD_OK && final_volume)
 			*final_volume = *volume;
 
@@ -300,10 +1385,10 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_setVolume(
 	FMOD::Studio::EventInstance* event_instance,
 	float volume)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_instance);
-	if (v_pFakeEvent->isValidHook())
+	if (IS_FAKE_EVENT(event_instance))
 	{
-		v_pFakeEvent->decodePointer()->updateVolume();
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		v_pFakeEvent->updateVolume();
 		return FMOD_OK;
 	}
 
@@ -314,10 +1399,12 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_getDescription(
 	FMOD::Studio::EventInstance* event_instance,
 	FMOD::Studio::EventDescription** event_description)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_instance);
-	if (v_pFakeEvent->isValidHook())
+	if (IS_FAKE_EVENT(event_instance))
 	{
-		*event_description = reinterpret_cast<FMOD::Studio::EventDescription*>(v_pFakeEvent);
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+
+		//Instances from an earlier world load get a stale description, so it can't reach the real FMOD functions
+		*event_description = encodeSoundId(v_pFakeEvent->m_soundId, v_pFakeEvent->m_generation);
 		return FMOD_OK;
 	}
 
@@ -328,12 +1415,11 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_getPlaybackState(
 	FMOD::Studio::EventInstance* event_instance,
 	FMOD_STUDIO_PLAYBACK_STATE* state)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_instance);
-	if (v_pFakeEvent->isValidHook())
+	if (IS_FAKE_EVENT(event_instance))
 	{
-		const bool v_isPlaying = v_pFakeEvent->decodePointer()->isPlaying();
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		*state = v_pFakeEvent->getPlaybackState();
 
-		*state = v_isPlaying ? FMOD_STUDIO_PLAYBACK_PLAYING : FMOD_STUDIO_PLAYBACK_STOPPED;
 		return FMOD_OK;
 	}
 
@@ -344,9 +1430,26 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_getTimelinePosition(
 	FMOD::Studio::EventInstance* event_instance,
 	int* position)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_instance);
-	if (v_pFakeEvent->isValidHook())
-		return v_pFakeEvent->decodePointer()->m_pChannel->getPosition(reinterpret_cast<std::uint32_t*>(position), FMOD_TIMEUNIT_MS);
+	if (IS_FAKE_EVENT(event_instance))
+	{
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		if (v_pFakeEvent->m_isVirtual)
+		{
+			std::uint32_t v_position;
+			v_pFakeEvent->getVirtualPosition(v_position);
+
+			*position = static_cast<int>(v_position);
+			return FMOD_OK;
+		}
+
+		if (!v_pFakeEvent->m_pChannel || (v_pFakeEvent->m_dirtyFlags & FakeEventDescription::DirtyPosition))
+		{
+			*position = static_cast<int>(v_pFakeEvent->m_positionMs);
+			return FMOD_OK;
+		}
+
+		return v_pFakeEvent->m_pChannel->getPosition(reinterpret_cast<std::uint32_t*>(position), FMOD_TIMEUNIT_MS);
+	}
 
 	return FMODHooks::o_FMOD_Studio_EventInstance_getTimelinePosition(event_instance, position);
 }
@@ -355,9 +1458,11 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_setTimelinePosition(
 	FMOD::Studio::EventInstance* event_instance,
 	int position)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_instance);
-	if (v_pFakeEvent->isValidHook())
-		return v_pFakeEvent->decodePointer()->m_pChannel->setPosition(static_cast<std::uint32_t>(position), FMOD_TIMEUNIT_MS);
+	if (IS_FAKE_EVENT(event_instance))
+	{
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		return v_pFakeEvent->setTimelinePosition(static_cast<std::uint32_t>(position));
+	}
 
 	return FMODHooks::o_FMOD_Studio_EventInstance_setTimelinePosition(event_instance, position);
 }
@@ -367,10 +1472,19 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_getPitch(
 	float* pitch,
 	float* finalpitch)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_instance);
-	if (v_pFakeEvent->isValidHook())
+	if (IS_FAKE_EVENT(event_instance))
 	{
-		FMOD_RESULT v_result = v_pFakeEvent->decodePointer()->m_pChannel->getPitch(pitch);
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		if (!v_pFakeEvent->m_pChannel || (v_pFakeEvent->m_dirtyFlags & FakeEventDescription::DirtyPitch))
+		{
+			*pitch = v_pFakeEvent->m_fPitch;
+			if (finalpitch)
+				*finalpitch = *pitch;
+
+			return FMOD_OK;
+		}
+
+		FMOD_RESULT v_result = v_pFakeEvent->m_pChannel->getPitch(pitch);
 		if (v_result == FMOD_OK && finalpitch)
 			*finalpitch = *pitch;
 
@@ -384,10 +1498,10 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_setPitch(
 	FMOD::Studio::EventInstance* event_instance,
 	float pitch)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_instance);
-	if (v_pFakeEvent->isValidHook())
+	if (IS_FAKE_EVENT(event_instance))
 	{
-		v_pFakeEvent->decodePointer()->m_pChannel->setPitch(pitch);
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		v_pFakeEvent->setPitch(pitch);
 		return FMOD_OK;
 	}
 
@@ -398,7 +1512,7 @@ using v_fmod_set_parameter_function = FMOD_RESULT(*)(FakeEventDescription* fake_
 
 static FMOD_RESULT fake_event_desc_setPitch(FakeEventDescription* fake_event, float value)
 {
-	fake_event->m_pChannel->setPitch(value);
+	fake_event->setPitch(value);
 	return FMOD_OK;
 }
 
@@ -410,9 +1524,7 @@ static FMOD_RESULT fake_event_desc_setVolume(FakeEventDescription* fake_event, f
 
 static FMOD_RESULT fake_event_desc_setReverb(FakeEventDescription* fake_event, float reverb)
 {
-	if (fake_event->m_reverbIdx != -1)
-		fake_event->m_pChannel->setReverbProperties(fake_event->m_reverbIdx, reverb);
-
+	fake_event->setReverbLevel(reverb);
 	return FMOD_OK;
 }
 
@@ -434,46 +1546,358 @@ static FMOD_RESULT fake_event_desc_setPosition(FakeEventDescription* fake_event,
 	return FMOD_OK;
 }
 
-inline static std::unordered_map<std::string_view, v_fmod_set_parameter_function> g_fakeEventParameterTable =
+static FMOD_RESULT fake_event_desc_setFadeTime(FakeEventDescription* fake_event, float fade_time)
+{
+	fake_event->m_fFadeTime = std::max(fade_time, 0.0f);
+	return FMOD_OK;
+}
+
+static FMOD_RESULT fake_event_desc_fadeTo(FakeEventDescription* fake_event, float target)
+{
+	return fake_event->fadeTo(std::max(target, 0.0f), static_cast<std::uint32_t>(fake_event->m_fFadeTime * 1000.0f));
+}
+
+static FMOD_RESULT fake_event_desc_setStartDelay(FakeEventDescription* fake_event, float start_delay)
+{
+	fake_event->m_fStartDelay = std::max(start_delay, 0.0f);
+	return FMOD_OK;
+}
+
+static FMOD_RESULT fake_event_desc_setStopDelay(FakeEventDescription* fake_event, float stop_delay)
+{
+	fake_event->m_fStopDelay = std::max(stop_delay, 0.0f);
+	return FMOD_OK;
+}
+
+//Indexed by FakeEventParameter
+static constexpr v_fmod_set_parameter_function g_fakeEventParameterTable[] =
+{
+	fake_event_desc_setPitch,
+	fake_event_desc_setVolume,
+	fake_event_desc_setReverb,
+	fake_event_desc_setReverbIndex,
+	fake_event_desc_setPosition,
+	fake_event_desc_fadeTo,
+	fake_event_desc_setFadeTime,
+	fake_event_desc_setStartDelay,
+	fake_event_desc_setStopDelay
+};
+
+static_assert(std::size(g_fakeEventParameterTable) == std::size_t(FakeEventParameter::Count));
+
+//Synthetic parameter ids are {CAE_PARAMETER_ID_MAGIC, FakeEventParameter}, so callers that cache the ids skip the name lookup.
+//The legacy names share the ids of the CAE_ names
+#define CAE_PARAMETER_ID_MAGIC 0xCAE0CAE0
+
+static FMOD_STUDIO_PARAMETER_ID get_fake_event_parameter_id(const FakeEventParameter parameter) noexcept
+{
+	return FMOD_STUDIO_PARAMETER_ID{ CAE_PARAMETER_ID_MAGIC, static_cast<unsigned int>(parameter) };
+}
+
+static FakeEventParameter get_fake_event_parameter(const FMOD_STUDIO_PARAMETER_ID& id) noexcept
 {
-	//Legacy audio parameters
-	{ "DLM_Pitch"    , fake_event_desc_setPitch       },
-	{ "DLM_Volume"   , fake_event_desc_setVolume      },
-	{ "DLM_Reverb"   , fake_event_desc_setReverb      },
-	{ "DLM_ReverbIdx", fake_event_desc_setReverbIndex },
+	if (id.data1 != CAE_PARAMETER_ID_MAGIC || id.data2 >= static_cast<unsigned int>(FakeEventParameter::Count))
+		return FakeEventParameter::Count;
 
-	//New audio parameters
-	{ "CAE_Pitch"    , fake_event_desc_setPitch       },
-	{ "CAE_Volume"   , fake_event_desc_setVolume      },
-	{ "CAE_Reverb"   , fake_event_desc_setReverb      },
-	{ "CAE_ReverbIdx", fake_event_desc_setReverbIndex },
-	{ "CAE_Position" , fake_event_desc_setPosition    }
+	return static_cast<FakeEventParameter>(id.data2);
+}
+
+struct FakeEventParameterInfo
+{
+	const char* name;
+	float minimum;
+	float maximum;
+	float defaultValue;
+};
+
+//Indexed by FakeEventParameter
+static constexpr FakeEventParameterInfo g_fakeEventParameterInfo[] =
+{
+	{ "CAE_Pitch"     , 0.0f , 10.0f    , 1.0f  },
+	{ "CAE_Volume"    , 0.0f , 10.0f    , 1.0f  },
+	{ "CAE_Reverb"    , 0.0f , 1.0f     , 1.0f  },
+	{ "CAE_ReverbIdx" , -1.0f, 3.0f     , -1.0f },
+	{ "CAE_Position"  , 0.0f , 86400.0f , 0.0f  },
+	{ "CAE_FadeTo"    , 0.0f , 10.0f    , 1.0f  },
+	{ "CAE_FadeTime"  , 0.0f , 3600.0f  , 0.0f  },
+	{ "CAE_StartDelay", 0.0f , 3600.0f  , 0.0f  },
+	{ "CAE_StopDelay" , 0.0f , 3600.0f  , 0.0f  }
 };
 
+static_assert(std::size(g_fakeEventParameterInfo) == std::size_t(FakeEventParameter::Count));
+
+static FMOD_RESULT get_fake_event_parameter_value(
+	FMOD::Studio::EventInstance* event_instance,
+	FakeEventDescription* fake_event,
+	const FakeEventParameter parameter,
+	float* value,
+	float* finalvalue)
+{
+	float v_value;
+	switch (parameter)
+	{
+	case FakeEventParameter::Pitch:
+		v_value = fake_event->m_fPitch;
+		break;
+	case FakeEventParameter::Volume:
+		v_value = fake_event->m_fCustomVolume;
+		break;
+	case FakeEventParameter::Reverb:
+		v_value = fake_event->m_fReverbLevel;
+		break;
+	case FakeEventParameter::ReverbIdx:
+		v_value = static_cast<float>(fake_event->m_reverbIdx);
+		break;
+	case FakeEventParameter::FadeTo:
+		v_value = fake_event->m_fFadeTo;
+		break;
+	case FakeEventParameter::FadeTime:
+		v_value = fake_event->m_fFadeTime;
+		break;
+	case FakeEventParameter::StartDelay:
+		v_value = fake_event->m_fStartDelay;
+		break;
+	case FakeEventParameter::StopDelay:
+		v_value = fake_event->m_fStopDelay;
+		break;
+	case FakeEventParameter::Position:
+		{
+			int v_positionMs;
+			const FMOD_RESULT v_result = FMODHooks::h_FMOD_Studio_EventInstance_getTimelinePosition(event_instance, &v_positionMs);
+			if (v_result != FMOD_OK) return v_result;
+
+			v_value = static_cast<float>(v_positionMs) / 1000.0f;
+			break;
+		}
+	default:
+		return FMOD_ERR_EVENT_NOTFOUND;
+	}
+
+	if (value) *value = v_value;
+	if (finalvalue) *finalvalue = v_value;
+
+	return FMOD_OK;
+}
+
 FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_setParameterByName(
 	FMOD::Studio::EventInstance* event_instance,
 	const char* name,
 	float value,
 	bool ignoreseekspeed)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_instance);
-	if (v_pFakeEvent->isValidHook())
+	if (IS_FAKE_EVENT(event_instance))
 	{
-		auto v_iter = g_fakeEventParameterTable.find(std::string_view(name));
-		if (v_iter != g_fakeEventParameterTable.end())
-			return v_iter->second(v_pFakeEvent->decodePointer(), value);
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		const FakeEventParameter v_parameter = get_fake_event_parameter(name);
+		if (v_parameter != FakeEventParameter::Count)
+			return g_fakeEventParameterTable[std::size_t(v_parameter)](v_pFakeEvent, value);
 	}
 
 	return FMODHooks::o_FMOD_Studio_EventInstance_setParameterByName(event_instance, name, value, ignoreseekspeed);
 }
 
+FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_getParameterByName(
+	FMOD::Studio::EventInstance* event_instance,
+	const char* name,
+	float* value,
+	float* finalvalue)
+{
+	if (IS_FAKE_EVENT(event_instance))
+	{
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		return get_fake_event_parameter_value(event_instance, v_pFakeEvent,
+			get_fake_event_parameter(name), value, finalvalue);
+	}
+
+	return FMODHooks::o_FMOD_Studio_EventInstance_getParameterByName(event_instance, name, value, finalvalue);
+}
+
+FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_getParameterByID(
+	FMOD::Studio::EventInstance* event_instance,
+	FMOD_STUDIO_PARAMETER_ID id,
+	float* value,
+	float* finalvalue)
+{
+	if (IS_FAKE_EVENT(event_instance))
+	{
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		return get_fake_event_parameter_value(event_instance, v_pFakeEvent, get_fake_event_parameter(id), value, finalvalue);
+	}
+
+	return FMODHooks::o_FMOD_Studio_EventInstance_getParameterByID(event_instance, id, value, finalvalue);
+}
+
+FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_setParameterByID(
+	FMOD::Studio::EventInstance* event_instance,
+	FMOD_STUDIO_PARAMETER_ID id,
+	float value,
+	bool ignoreseekspeed)
+{
+	if (IS_FAKE_EVENT(event_instance))
+	{
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		const FakeEventParameter v_parameter = get_fake_event_parameter(id);
+		if (v_parameter == FakeEventParameter::Count)
+			return FMOD_ERR_EVENT_NOTFOUND;
+
+		return g_fakeEventParameterTable[std::size_t(v_parameter)](v_pFakeEvent, value);
+	}
+
+	return FMODHooks::o_FMOD_Studio_EventInstance_setParameterByID(event_instance, id, value, ignoreseekspeed);
+}
+
+FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_setParametersByIDs(
+	FMOD::Studio::EventInstance* event_instance,
+	const FMOD_STUDIO_PARAMETER_ID* ids,
+	float* values,
+	int count,
+	bool ignoreseekspeed)
+{
+	if (IS_FAKE_EVENT(event_instance))
+	{
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		if (!ids || !values || count < 0)
+			return FMOD_ERR_INVALID_PARAM;
+
+		//The setters only mark the instance as dirty, so the whole batch reaches the channel in one flush
+		FMOD_RESULT v_result = FMOD_OK;
+		for (int a = 0; a < count; a++)
+		{
+			const FakeEventParameter v_parameter = get_fake_event_parameter(ids[a]);
+			if (v_parameter == FakeEventParameter::Count)
+			{
+				v_result = FMOD_ERR_EVENT_NOTFOUND;
+				continue;
+			}
+
+			g_fakeEventParameterTable[std::size_t(v_parameter)](v_pFakeEvent, values[a]);
+		}
+
+		return v_result;
+	}
+
+	return FMODHooks::o_FMOD_Studio_EventInstance_setParametersByIDs(event_instance, ids, values, count, ignoreseekspeed);
+}
+
+FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_setCallback(
+	FMOD::Studio::EventInstance* event_instance,
+	FMOD_STUDIO_EVENT_CALLBACK callback,
+	FMOD_STUDIO_EVENT_CALLBACK_TYPE callbackmask)
+{
+	if (IS_FAKE_EVENT(event_instance))
+	{
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		v_pFakeEvent->m_pCallback = callback;
+		v_pFakeEvent->m_callbackMask = callbackmask;
+		//Only the changes after this call are reported
+		v_pFakeEvent->m_callbackStarted = v_pFakeEvent->isPlaying();
+
+		return FMOD_OK;
+	}
+
+	return FMODHooks::o_FMOD_Studio_EventInstance_setCallback(event_instance, callback, callbackmask);
+}
+
+FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_setUserData(
+	FMOD::Studio::EventInstance* event_instance,
+	void* userdata)
+{
+	if (IS_FAKE_EVENT(event_instance))
+	{
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		v_pFakeEvent->m_pUserData = userdata;
+		return FMOD_OK;
+	}
+
+	return FMODHooks::o_FMOD_Studio_EventInstance_setUserData(event_instance, userdata);
+}
+
+FMOD_RESULT FMODHooks::h_FMOD_Studio_EventInstance_getUserData(
+	FMOD::Studio::EventInstance* event_instance,
+	void** userdata)
+{
+	if (IS_FAKE_EVENT(event_instance))
+	{
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_instance);
+		if (!userdata) return FMOD_ERR_INVALID_PARAM;
+
+		*userdata = v_pFakeEvent->m_pUserData;
+		return FMOD_OK;
+	}
+
+	return FMODHooks::o_FMOD_Studio_EventInstance_getUserData(event_instance, userdata);
+}
+
+FMOD_RESULT FMODHooks::h_FMOD_Studio_EventDescription_getParameterDescriptionByName(
+	FMOD::Studio::EventDescription* event_desc,
+	const char* name,
+	FMOD_STUDIO_PARAMETER_DESCRIPTION* parameter)
+{
+	if (IS_FAKE_EVENT(event_desc) || IS_FAKE_EVENT_DESC(event_desc))
+	{
+		if (!name || !parameter)
+			return FMOD_ERR_INVALID_PARAM;
+
+		const FakeEventParameter v_parameter = get_fake_event_parameter(name);
+		if (v_parameter == FakeEventParameter::Count)
+			return FMOD_ERR_EVENT_NOTFOUND;
+
+		const FakeEventParameterInfo& v_info = g_fakeEventParameterInfo[std::size_t(v_parameter)];
+
+		*parameter = {};
+		parameter->name = v_info.name;
+		parameter->id = get_fake_event_parameter_id(v_parameter);
+		parameter->minimum = v_info.minimum;
+		parameter->maximum = v_info.maximum;
+		parameter->defaultvalue = v_info.defaultValue;
+		parameter->type = FMOD_STUDIO_PARAMETER_GAME_CONTROLLED;
+
+		return FMOD_OK;
+	}
+
+	return FMODHooks::o_FMOD_Studio_EventDescription_getParameterDescriptionByName(event_desc, name, parameter);
+}
+
 FMOD_RESULT FMODHooks::h_FMOD_Studio_EventDescription_getLength(
 	FMOD::Studio::EventDescription* event_desc,
 	int* length)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_desc);
-	if (v_pFakeEvent->isValidHook())
-		return v_pFakeEvent->decodePointer()->m_pSound->getLength(reinterpret_cast<std::uint32_t*>(length), FMOD_TIMEUNIT_MS);
+	if (IS_FAKE_EVENT(event_desc))
+	{
+		FAKE_EVENT_RESOLVE(v_pFakeEvent, event_desc);
+		if (!v_pFakeEvent->m_pSound) return FMOD_ERR_NOTREADY;
+
+		return v_pFakeEvent->m_pSound->getLength(reinterpret_cast<std::uint32_t*>(length), FMOD_TIMEUNIT_MS);
+	}
+
+	if (IS_FAKE_EVENT_DESC(event_desc))
+	{
+		const SoundData* v_pSoundData = SoundStorage::GetSoundData(decodeSoundId(event_desc));
+		if (!v_pSoundData) return FMOD_ERR_INVALID_HANDLE;
+
+		if (SoundStorage::IsStream(v_pSoundData->pathId))
+		{
+			FMOD::Sound* v_pStream = SoundStorage::CreateStream(v_pSoundData->pathId, FMOD_OPENONLY);
+			if (!v_pStream) return FMOD_ERR_FILE_NOTFOUND;
+
+			const FMOD_RESULT v_result = v_pStream->getLength(reinterpret_cast<std::uint32_t*>(length), FMOD_TIMEUNIT_MS);
+			v_pStream->release();
+
+			return v_result;
+		}
+
+		//Loaded like an instance would, so the load policy applies and the sound counts as used
+		FMOD::Sound* v_pSound;
+		const FMOD_RESULT v_acquireResult = SoundStorage::AcquireSound(*v_pSoundData, &v_pSound);
+		if (v_acquireResult != FMOD_OK) return v_acquireResult;
+
+		const FMOD_RESULT v_result = v_pSound
+			? v_pSound->getLength(reinterpret_cast<std::uint32_t*>(length), FMOD_TIMEUNIT_MS)
+			: FMOD_ERR_NOTREADY;
+
+		SoundStorage::ReleaseSound(v_pSoundData->pathId);
+		return v_result;
+	}
 
 	return FMODHooks::o_FMOD_Studio_EventDescription_getLength(event_desc, length);
 }
@@ -482,13 +1906,66 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_EventDescription_createInstance(
 	FMOD::Studio::EventDescription* event_desc,
 	FMOD::Studio::EventInstance** instance)
 {
-	SoundData* v_pSoundData = SoundStorage::GetSoundData(reinterpret_cast<std::size_t>(event_desc));
-	if (v_pSoundData)
+	if (IS_FAKE_EVENT_DESC(event_desc))
 	{
-		FakeEventDescription* v_newFakeEvent = new FakeEventDescription(v_pSoundData, nullptr);
-		v_newFakeEvent->playSound();
+		const std::uint32_t v_soundId = decodeSoundId(event_desc);
+		SoundData* v_pSoundData = SoundStorage::GetSoundData(v_soundId);
+		if (!v_pSoundData)
+		{
+			*instance = nullptr;
+			return FMOD_ERR_INVALID_HANDLE;
+		}
+
+		update_sound_loads();
+
+		//The sound is acquired first, no voice is stolen for an instance that can't be created
+		FMOD::Sound* v_pSound;
+		const FMOD_RESULT v_result = SoundStorage::AcquireSound(*v_pSoundData, &v_pSound);
+		if (v_result != FMOD_OK)
+		{
+			*instance = nullptr;
+			return v_result;
+		}
+
+		FMOD_RESULT v_limitResult = FMOD_OK;
+		if (!enforce_instance_limit(*v_pSoundData))
+			v_limitResult = FMOD_ERR_MAXAUDIBLE;
+		//Keeps mods that never release their instances from growing the pool for the whole session
+		else if (g_fakeEventPool.size() >= CAE_MAX_FAKE_EVENT_INSTANCES && !reclaim_fake_event())
+			v_limitResult = FMOD_ERR_MEMORY;
+
+		if (v_limitResult != FMOD_OK)
+		{
+			SoundStorage::ReleaseSound(v_pSoundData->pathId);
+			if (v_pSound && SoundStorage::IsStream(v_pSoundData->pathId))
+				v_pSound->release();
+
+			*instance = nullptr;
+			return v_limitResult;
+		}
+
+		FakeEventDescription* v_newFakeEvent;
+		const std::uint64_t v_handle = g_fakeEventPool.create(&v_newFakeEvent, v_pSoundData, v_pSound, nullptr);
+		v_newFakeEvent->m_handle = v_handle;
+		v_newFakeEvent->m_soundId = v_soundId;
+		v_newFakeEvent->m_createdMs = GetTickCount64();
+
+		if (v_pSoundData->effectData.maxInstances != 0)
+			v_pSoundData->liveInstances.push_back(v_handle);
+
+		if (v_pSound && SoundStorage::IsSoundReady(v_pSound))
+		{
+			//Coalesced sounds only get a channel once start decides if the trigger needs its own voice
+			if (v_pSoundData->effectData.coalesceWindowMs == 0)
+				v_newFakeEvent->playSound();
+		}
+		else
+		{
+			v_newFakeEvent->m_waitingForSound = true;
+			g_waitingFakeEvents.push_back(v_newFakeEvent);
+		}
 
-		*instance = reinterpret_cast<FMOD::Studio::EventInstance*>(v_newFakeEvent->encodePointer());
+		*instance = reinterpret_cast<FMOD::Studio::EventInstance*>(v_handle);
 		return FMOD_OK;
 	}
 
@@ -499,8 +1976,7 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_EventDescription_hasSustainPoint(
 	FMOD::Studio::EventDescription* event_desc,
 	bool* has_sustain)
 {
-	FakeEventDescription* v_pFakeEvent = FAKE_EVENT_CAST(event_desc);
-	if (v_pFakeEvent->isValidHook())
+	if (IS_FAKE_EVENT(event_desc) || IS_FAKE_EVENT_DESC(event_desc))
 	{
 		*has_sustain = false;
 		return FMOD_OK;
@@ -516,6 +1992,7 @@ union FAKE_GUID_DATA
 	FMOD_GUID guid;
 	struct
 	{
+		//Name hashes stay valid across reloads, unlike sound ids
 		std::size_t hash;
 		std::size_t secret;
 	} fake;
@@ -526,12 +2003,17 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_System_lookupID(
 	const char* path,
 	FMOD_GUID* id)
 {
-	const std::size_t sound_hash = std::hash<std::string>{}(std::string(path));
-	if (SoundStorage::SoundExists(sound_hash))
+	const std::size_t v_nameHash = SoundStorage::HashName(std::string_view(path));
+	const std::uint32_t v_soundId = SoundStorage::FindSoundId(v_nameHash);
+	if (v_soundId != SoundStorage::InvalidId)
 	{
+		//The event is usually created right after the lookup, give the sound a head start
+		SoundStorage::PrefetchSound(v_soundId);
+		update_sound_loads();
+
 		FAKE_GUID_DATA* v_fake_guid = reinterpret_cast<FAKE_GUID_DATA*>(id);
 
-		v_fake_guid->fake.hash = sound_hash;
+		v_fake_guid->fake.hash = v_nameHash;
 		v_fake_guid->fake.secret = FMOD_HOOK_FAKE_GUID_SECRET;
 
 		return FMOD_OK;
@@ -548,9 +2030,12 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_System_getEventByID(
 	const FAKE_GUID_DATA* v_guid_data = reinterpret_cast<const FAKE_GUID_DATA*>(id);
 	if (v_guid_data->fake.secret == FMOD_HOOK_FAKE_GUID_SECRET)
 	{
-		if (SoundStorage::SoundExists(v_guid_data->fake.hash))
+		const std::uint32_t v_soundId = SoundStorage::FindSoundId(v_guid_data->fake.hash);
+		if (v_soundId != SoundStorage::InvalidId)
 		{
-			*event_id = reinterpret_cast<FMOD::Studio::EventDescription*>(v_guid_data->fake.hash);
+			SoundStorage::PrefetchSound(v_soundId);
+
+			*event_id = encodeSoundId(v_soundId);
 			return FMOD_OK;
 		}
 	}
@@ -558,6 +2043,34 @@ FMOD_RESULT FMODHooks::h_FMOD_Studio_System_getEventByID(
 	return FMODHooks::o_FMOD_Studio_System_getEventByID(system, id, event_id);
 }
 
+//One batched pass over the live instances per frame, instead of checking the distance in every hook
+static void update_virtual_voices()
+{
+	if (g_fakeEventPool.size() == 0) return;
+
+	FMOD_VECTOR v_listenerPos;
+	if (!get_listener_position(v_listenerPos))
+		return;
+
+	g_fakeEventPool.forEach([&v_listenerPos](FakeEventDescription& fake_event) {
+		fake_event.updateVirtualVoice(v_listenerPos);
+	});
+}
+
+FMOD_RESULT FMODHooks::h_FMOD_Studio_System_update(FMOD::Studio::System* system)
+{
+	update_sound_loads();
+	SoundMixer::Update();
+	//The virtual voice pass reads the channel position, so the seeks go out first
+	flush_fake_event_changes();
+	update_virtual_voices();
+	dispatch_fake_event_callbacks();
+	//Released instances are destroyed after their STOPPED callback went out
+	reap_fake_events();
+
+	return FMODHooks::o_FMOD_Studio_System_update(system);
+}
+
 struct FMODHookData
 {
 	const char* procName;
@@ -647,6 +2160,11 @@ static FMODHookData g_fmodHookData[] =
 		(LPVOID)FMODHooks::h_FMOD_Studio_System_getEventByID,
 		(LPVOID*)&FMODHooks::o_FMOD_Studio_System_getEventByID
 	},
+	{
+		"?update@System@Studio@FMOD@@QEAA?AW4FMOD_RESULT@@XZ",
+		(LPVOID)FMODHooks::h_FMOD_Studio_System_update,
+		(LPVOID*)&FMODHooks::o_FMOD_Studio_System_update
+	},
 	{
 		"?createInstance@EventDescription@Studio@FMOD@@QEBA?AW4FMOD_RESULT@@PEAPEAVEventInstance@23@@Z",
 		(LPVOID)FMODHooks::h_FMOD_Studio_EventDescription_createInstance,
@@ -661,6 +2179,46 @@ static FMODHookData g_fmodHookData[] =
 		"?setParameterByName@EventInstance@Studio@FMOD@@QEAA?AW4FMOD_RESULT@@PEBDM_N@Z",
 		(LPVOID)FMODHooks::h_FMOD_Studio_EventInstance_setParameterByName,
 		(LPVOID*)&FMODHooks::o_FMOD_Studio_EventInstance_setParameterByName
+	},
+	{
+		"?getParameterByName@EventInstance@Studio@FMOD@@QEBA?AW4FMOD_RESULT@@PEBDPEAM1@Z",
+		(LPVOID)FMODHooks::h_FMOD_Studio_EventInstance_getParameterByName,
+		(LPVOID*)&FMODHooks::o_FMOD_Studio_EventInstance_getParameterByName
+	},
+	{
+		"?getParameterByID@EventInstance@Studio@FMOD@@QEBA?AW4FMOD_RESULT@@UFMOD_STUDIO_PARAMETER_ID@@PEAM1@Z",
+		(LPVOID)FMODHooks::h_FMOD_Studio_EventInstance_getParameterByID,
+		(LPVOID*)&FMODHooks::o_FMOD_Studio_EventInstance_getParameterByID
+	},
+	{
+		"?setParameterByID@EventInstance@Studio@FMOD@@QEAA?AW4FMOD_RESULT@@UFMOD_STUDIO_PARAMETER_ID@@M_N@Z",
+		(LPVOID)FMODHooks::h_FMOD_Studio_EventInstance_setParameterByID,
+		(LPVOID*)&FMODHooks::o_FMOD_Studio_EventInstance_setParameterByID
+	},
+	{
+		"?setParametersByIDs@EventInstance@Studio@FMOD@@QEAA?AW4FMOD_RESULT@@PEBUFMOD_STUDIO_PARAMETER_ID@@PEAMH_N@Z",
+		(LPVOID)FMODHooks::h_FMOD_Studio_EventInstance_setParametersByIDs,
+		(LPVOID*)&FMODHooks::o_FMOD_Studio_EventInstance_setParametersByIDs
+	},
+	{
+		"?getParameterDescriptionByName@EventDescription@Studio@FMOD@@QEBA?AW4FMOD_RESULT@@PEBDPEAUFMOD_STUDIO_PARAMETER_DESCRIPTION@@@Z",
+		(LPVOID)FMODHooks::h_FMOD_Studio_EventDescription_getParameterDescriptionByName,
+		(LPVOID*)&FMODHooks::o_FMOD_Studio_EventDescription_getParameterDescriptionByName
+	},
+	{
+		"?setCallback@EventInstance@Studio@FMOD@@QEAA?AW4FMOD_RESULT@@P6A?AW44@IPEAUFMOD_STUDIO_EVENTINSTANCE@@PEAX@ZI@Z",
+		(LPVOID)FMODHooks::h_FMOD_Studio_EventInstance_setCallback,
+		(LPVOID*)&FMODHooks::o_FMOD_Studio_EventInstance_setCallback
+	},
+	{
+		"?setUserData@EventInstance@Studio@FMOD@@QEAA?AW4FMOD_RESULT@@PEAX@Z",
+		(LPVOID)FMODHooks::h_FMOD_Studio_EventInstance_setUserData,
+		(LPVOID*)&FMODHooks::o_FMOD_Studio_EventInstance_setUserData
+	},
+	{
+		"?getUserData@EventInstance@Studio@FMOD@@QEBA?AW4FMOD_RESULT@@PEAPEAX@Z",
+		(LPVOID)FMODHooks::h_FMOD_Studio_EventInstance_getUserData,
+		(LPVOID*)&FMODHooks::o_FMOD_Studio_EventInstance_getUserData
 	}
 };
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Audio/SoundStorage.hpp"
+
 #include <fmod/fmod_studio.hpp>
 #include <fmod/fmod.hpp>
 
@@ -24,6 +26,13 @@ namespace FEventInstance
 	using GetPitch = FMOD_RESULT(__fastcall*)(FMOD::Studio::EventInstance*, float*, float*);
 	using SetPitch = FMOD_RESULT(__fastcall*)(FMOD::Studio::EventInstance*, float);
 	using SetParameterByName = FMOD_RESULT(__fastcall*)(FMOD::Studio::EventInstance*, const char*, float, bool);
+	using GetParameterByName = FMOD_RESULT(__fastcall*)(FMOD::Studio::EventInstance*, const char*, float*, float*);
+	using GetParameterById = FMOD_RESULT(__fastcall*)(FMOD::Studio::EventInstance*, FMOD_STUDIO_PARAMETER_ID, float*, float*);
+	using SetParameterById = FMOD_RESULT(__fastcall*)(FMOD::Studio::EventInstance*, FMOD_STUDIO_PARAMETER_ID, float, bool);
+	using SetParametersByIds = FMOD_RESULT(__fastcall*)(FMOD::Studio::EventInstance*, const FMOD_STUDIO_PARAMETER_ID*, float*, int, bool);
+	using SetCallback = FMOD_RESULT(__fastcall*)(FMOD::Studio::EventInstance*, FMOD_STUDIO_EVENT_CALLBACK, FMOD_STUDIO_EVENT_CALLBACK_TYPE);
+	using SetUserData = FMOD_RESULT(__fastcall*)(FMOD::Studio::EventInstance*, void*);
+	using GetUserData = FMOD_RESULT(__fastcall*)(FMOD::Studio::EventInstance*, void**);
 }
 
 namespace FEventDescription
@@ -31,86 +40,206 @@ namespace FEventDescription
 	using GetLength = FMOD_RESULT(__fastcall*)(FMOD::Studio::EventDescription*, int*);
 	using CreateInstance = FMOD_RESULT(__fastcall*)(FMOD::Studio::EventDescription*, FMOD::Studio::EventInstance**);
 	using HasSustainPoint = FMOD_RESULT(__fastcall*)(FMOD::Studio::EventDescription*, bool*);
+	using GetParameterDescriptionByName = FMOD_RESULT(__fastcall*)(FMOD::Studio::EventDescription*, const char*, FMOD_STUDIO_PARAMETER_DESCRIPTION*);
 }
 
 namespace FStudioSystem
 {
 	using LookupId = FMOD_RESULT(__fastcall*)(FMOD::Studio::System*, const char*, FMOD_GUID*);
 	using GetEventById = FMOD_RESULT(__fastcall*)(FMOD::Studio::System*, const FMOD_GUID*, FMOD::Studio::EventDescription**);
+	using Update = FMOD_RESULT(__fastcall*)(FMOD::Studio::System*);
 }
 
-struct SoundEffectData
-{
-	bool is3D;
-	int reverbIdx;
-	float fMinDistance;
-	float fMaxDistance;
-};
+#define FAKE_EVENT_DESC_MAGIC 13372281488
 
-struct SoundData
-{
-	FMOD::Sound* sound;
-	SoundEffectData effectData;
-};
+//3D instances give up their channel once the listener is this much further away than the max distance,
+//they get it back as soon as the listener is within the max distance again
+#define CAE_VIRTUAL_VOICE_MARGIN 1.1f
 
-#define FAKE_EVENT_DESC_MAGIC 13372281488
+//Upper limit for the live fake instances, once it's reached createInstance reclaims the oldest stopped instance
+#define CAE_MAX_FAKE_EVENT_INSTANCES 8192
+#define CAE_LEAK_CHECK_INTERVAL_MS 1000
 
 struct FakeEventDescription
 {
-	FakeEventDescription(const SoundData* pSoundData, FMOD::Channel* pChannel);
+	//Channel properties that changed since the last flush
+	enum DirtyFlag : std::uint8_t
+	{
+		DirtyVolume     = 1 << 0,
+		DirtyPitch      = 1 << 1,
+		DirtyAttributes = 1 << 2,
+		DirtyReverb     = 1 << 3,
+		DirtyPosition   = 1 << 4,
+		//Fade points and the scheduled start and stop
+		DirtyFade       = 1 << 5
+	};
+
+	FakeEventDescription(const SoundData* pSoundData, FMOD::Sound* pSound, FMOD::Channel* pChannel);
+
+	//The setters only store the value, the channel gets the final values once per frame in flushChanges
 
 	FMOD_RESULT setVolume(const float newVolume);
+	FMOD_RESULT setPitch(const float newPitch);
 	FMOD_RESULT setPosition(const float newPosition);
+	FMOD_RESULT setTimelinePosition(const std::uint32_t newPosition);
+	FMOD_RESULT set3DAttributes(const FMOD_3D_ATTRIBUTES* attributes);
+	FMOD_RESULT setReverbLevel(const float newLevel);
 	FMOD_RESULT updateVolume();
+	//Ramps the fade level from its current value to the target with channel fade points
+	FMOD_RESULT fadeTo(const float target, const std::uint32_t durationMs, const double delayMs = 0.0);
+	float getFadeLevel() const;
+	//Time left until the scheduled start
+	double getStartDelayMs() const;
+
+	void markDirty(const std::uint8_t flags);
+	void applyChanges(const std::uint8_t flags);
+	void applySchedule();
+	void flushChanges();
+
+	FMOD_RESULT start();
+	//FMOD_STUDIO_STOP_ALLOWFADEOUT keeps the channel alive until the fade out of the sound has finished
+	FMOD_RESULT stop(const FMOD_STUDIO_STOP_MODE mode = FMOD_STUDIO_STOP_IMMEDIATE);
 
 	void updateReverbData();
 	void playSound();
+	//Returns true once the instance doesn't have to wait for its sound anymore
+	bool updateWaitingSound();
 
+	//Cached state, kept up to date by the channel callback and the instance calls instead of asking the channel
+	FMOD_STUDIO_PLAYBACK_STATE getPlaybackState() const;
 	bool isPlaying() const;
-	bool isValidHook() const noexcept;
-
-	FakeEventDescription* encodePointer() noexcept;
-	FakeEventDescription* decodePointer() noexcept;
-
+	//True while the instance holds a voice or is waiting to get one
+	bool isActive() const;
+	float getAudibility() const;
+	float getDistanceSq(const FMOD_VECTOR& listenerPos) const;
+	//Stops the instance for good, used when another instance takes its voice
+	void steal();
+	//Checks the instance limit of the sound before the instance gets a voice, steals a voice if the sound allows it
+	bool reserveVoice();
+
+	//Merges the start into a voice of the same sound that was started within the coalesce window
+	FMOD_RESULT startCoalesced();
+	//Called on the shared voice for every trigger that was merged into it
+	void mergeTrigger(const FakeEventDescription& trigger);
+
+	//Swaps the real channel for a virtual timeline when the listener is out of range and back
+	void updateVirtualVoice(const FMOD_VECTOR& listenerPos);
+	//Returns false once a non looping sound would have finished playing
+	bool getVirtualPosition(std::uint32_t& r_position) const;
+	//Loop region in milliseconds, the end is exclusive
+	void getLoopRegionMs(const std::uint32_t lengthMs, std::uint32_t& r_start, std::uint32_t& r_end) const;
+
+	//The channel callback keeps the cached playback state up to date
+	void attachChannelCallback();
+	//Must be called before a channel that is still playing is stopped or handed back, its END must not reach the instance
+	void detachChannel();
+	//Called by the callback dispatch on the game thread once the channel has ended on its own
+	void onChannelEnd();
+	//Queues STARTED and STOPPED if the playback state has changed since the last dispatch
+	void updateCallbackState();
+
+	//Releases the sound resources, the object itself is destroyed by the instance pool
 	FMOD_RESULT release();
 
 	FMOD::Sound* m_pSound;
 	FMOD::Channel* m_pChannel;
+	std::uint8_t m_dirtyFlags = 0;
+
+	//Only written on the game thread, by the instance calls and by the callback dispatch once the channel has ended
+	FMOD_STUDIO_PLAYBACK_STATE m_playbackState = FMOD_STUDIO_PLAYBACK_STOPPED;
+	//m_pChannel hasn't ended yet
+	bool m_hasVoice = false;
+
+	std::uint64_t m_handle = 0;
+	std::uint32_t m_soundId;
+	std::uint32_t m_pathId;
+	//Finds the path again once a reload has changed the path ids
+	std::size_t m_pathKey;
+	//Finds the sound again if it was retired while the instance was holding it
+	std::uint32_t m_soundSerial;
+	std::uint32_t m_busId;
+	std::uint32_t m_generation;
+	//Streams can't be shared between channels, so every instance releases its own
+	bool m_ownsSound;
 
 	float m_fCustomVolume = 1.0f;
+	float m_fPitch = 1.0f;
+	float m_fReverbLevel = 1.0f;
 	int m_reverbIdx;
 
+	std::uint16_t m_coalesceWindowMs;
+	SoundCoalesceVolume m_coalesceVolume;
+	SoundCoalescePosition m_coalescePosition;
+
+	//Multiplier for the merged triggers of a coalesced voice
+	float m_fCoalesceGain = 1.0f;
+	//Loudest volume of the merged triggers, kept apart so the voice still reports its own volume
+	float m_fMergedVolume = 0.0f;
+	float m_fLoudestTrigger = 0.0f;
+	std::uint32_t m_mergedCount = 0;
+	//Shared voice this instance was merged into
+	std::uint64_t m_proxyHandle = 0;
+
+	//Set with CAE_FadeTime, used by the next CAE_FadeTo
+	float m_fFadeTime = 0.0f;
+	//Volume multiplier applied with fade points, ramps from m_fFadeFrom to m_fFadeTo over m_fadeDurationMs
+	float m_fFadeFrom = 1.0f;
+	float m_fFadeTo = 1.0f;
+	double m_fadeStartMs = 0.0;
+	std::uint32_t m_fadeDurationMs = 0;
+	std::uint16_t m_fadeInMs;
+	std::uint16_t m_fadeOutMs;
+	//The channel stops itself once the fade out or the stop delay has finished
+	bool m_fadingOut = false;
+
+	//Set with CAE_StartDelay and CAE_StopDelay, measured in seconds
+	float m_fStartDelay = 0.0f;
+	float m_fStopDelay = 0.0f;
+	//Starts are moved to the next point of the sequence grid on the mixer clock
+	std::uint16_t m_sequenceIntervalMs;
+	std::uint16_t m_sequenceOffsetMs;
+	//Mixer clock of the scheduled start, 0 if the instance starts right away
+	unsigned long long m_startClock = 0;
+
+	std::int16_t m_loopCount;
+	SoundLoopUnit m_loopUnit;
+	std::uint32_t m_loopStart;
+	std::uint32_t m_loopEnd;
+
+	//Emulated Studio callback, called from Studio::System::update
+	FMOD_STUDIO_EVENT_CALLBACK m_pCallback = nullptr;
+	FMOD_STUDIO_EVENT_CALLBACK_TYPE m_callbackMask = 0;
+	void* m_pUserData = nullptr;
+	//STARTED was sent and STOPPED wasn't yet
+	bool m_callbackStarted = false;
+
+	FMOD_3D_ATTRIBUTES m_attributes = {};
+	std::uint32_t m_positionMs = 0;
+	bool m_hasAttributes = false;
+	bool m_hasPosition = false;
+
+	//Studio::EventInstance::release was called while the instance was playing, it's destroyed once it has stopped
+	bool m_releaseRequested = false;
+	//GetTickCount64 at the creation of the instance
+	std::uint64_t m_createdMs = 0;
+	bool m_leakReported = false;
+
+	//The sound was still loading when the instance was created
+	bool m_waitingForSound = false;
+	bool m_startRequested = false;
+	//Another instance of the same sound took the voice
+	bool m_stolen = false;
+
+	//The channel was released, m_positionMs was the position at m_virtualStartMs
+	bool m_isVirtual = false;
+	double m_virtualStartMs = 0.0;
+
 	float m_fMinDistance;
 	float m_fMaxDistance;
 
 	bool m_is3D;
 };
 
-class SoundStorage
-{
-public:
-	static void ClearSounds();
-
-	static bool SoundExists(const std::size_t nameHash);
-	static SoundData* GetSoundData(const std::size_t nameHash);
-
-	static std::size_t SavePath(const std::string_view& path);
-	static bool GetPath(const std::size_t hash, std::string& outPath);
-
-	static FMOD::Sound* CreateSound(const std::string_view& path);
-	static void PreloadSound(
-		const std::string_view& sound_path,
-		const std::string_view& sound_name,
-		const SoundEffectData& effect_data
-	);
-
-public:
-	inline static std::unordered_map<std::size_t, std::string> HashToPath;
-
-	inline static std::unordered_map<std::size_t, FMOD::Sound*> PathHashToSound;
-	inline static std::unordered_map<std::size_t, SoundData> NameHashToSound;
-};
-
 class FMODHooks
 {
 public:
@@ -128,6 +257,13 @@ public:
 	inline static FEventInstance::GetPitch o_FMOD_Studio_EventInstance_getPitch = nullptr;
 	inline static FEventInstance::SetPitch o_FMOD_Studio_EventInstance_setPitch = nullptr;
 	inline static FEventInstance::SetParameterByName o_FMOD_Studio_EventInstance_setParameterByName = nullptr;
+	inline static FEventInstance::GetParameterByName o_FMOD_Studio_EventInstance_getParameterByName = nullptr;
+	inline static FEventInstance::GetParameterById o_FMOD_Studio_EventInstance_getParameterByID = nullptr;
+	inline static FEventInstance::SetParameterById o_FMOD_Studio_EventInstance_setParameterByID = nullptr;
+	inline static FEventInstance::SetParametersByIds o_FMOD_Studio_EventInstance_setParametersByIDs = nullptr;
+	inline static FEventInstance::SetCallback o_FMOD_Studio_EventInstance_setCallback = nullptr;
+	inline static FEventInstance::SetUserData o_FMOD_Studio_EventInstance_setUserData = nullptr;
+	inline static FEventInstance::GetUserData o_FMOD_Studio_EventInstance_getUserData = nullptr;
 
 	static FMOD_RESULT h_FMOD_Studio_EventInstance_release(FMOD::Studio::EventInstance* event_instance);
 	static FMOD_RESULT h_FMOD_Studio_EventInstance_start(FMOD::Studio::EventInstance* event_instance);
@@ -143,16 +279,25 @@ public:
 	static FMOD_RESULT h_FMOD_Studio_EventInstance_getPitch(FMOD::Studio::EventInstance* event_instance, float* pitch, float* finalpitch);
 	static FMOD_RESULT h_FMOD_Studio_EventInstance_setPitch(FMOD::Studio::EventInstance* event_instance, float pitch);
 	static FMOD_RESULT h_FMOD_Studio_EventInstance_setParameterByName(FMOD::Studio::EventInstance* event_instance, const char* name, float value, bool ignoreseekspeed);
+	static FMOD_RESULT h_FMOD_Studio_EventInstance_getParameterByName(FMOD::Studio::EventInstance* event_instance, const char* name, float* value, float* finalvalue);
+	static FMOD_RESULT h_FMOD_Studio_EventInstance_getParameterByID(FMOD::Studio::EventInstance* event_instance, FMOD_STUDIO_PARAMETER_ID id, float* value, float* finalvalue);
+	static FMOD_RESULT h_FMOD_Studio_EventInstance_setParameterByID(FMOD::Studio::EventInstance* event_instance, FMOD_STUDIO_PARAMETER_ID id, float value, bool ignoreseekspeed);
+	static FMOD_RESULT h_FMOD_Studio_EventInstance_setParametersByIDs(FMOD::Studio::EventInstance* event_instance, const FMOD_STUDIO_PARAMETER_ID* ids, float* values, int count, bool ignoreseekspeed);
+	static FMOD_RESULT h_FMOD_Studio_EventInstance_setCallback(FMOD::Studio::EventInstance* event_instance, FMOD_STUDIO_EVENT_CALLBACK callback, FMOD_STUDIO_EVENT_CALLBACK_TYPE callbackmask);
+	static FMOD_RESULT h_FMOD_Studio_EventInstance_setUserData(FMOD::Studio::EventInstance* event_instance, void* userdata);
+	static FMOD_RESULT h_FMOD_Studio_EventInstance_getUserData(FMOD::Studio::EventInstance* event_instance, void** userdata);
 
 	//FMOD EVENT DESCRIPTION HOOKS
 
 	inline static FEventDescription::GetLength o_FMOD_Studio_EventDescription_getLength = nullptr;
 	inline static FEventDescription::CreateInstance o_FMOD_Studio_EventDescription_createInstance = nullptr;
 	inline static FEventDescription::HasSustainPoint o_FMOD_Studio_EventDescription_hasSustainPoint = nullptr;
+	inline static FEventDescription::GetParameterDescriptionByName o_FMOD_Studio_EventDescription_getParameterDescriptionByName = nullptr;
 
 	static FMOD_RESULT h_FMOD_Studio_EventDescription_getLength(FMOD::Studio::EventDescription* event_desc, int* length);
 	static FMOD_RESULT h_FMOD_Studio_EventDescription_createInstance(FMOD::Studio::EventDescription* event_desc, FMOD::Studio::EventInstance** instance);
 	static FMOD_RESULT h_FMOD_Studio_EventDescription_hasSustainPoint(FMOD::Studio::EventDescription* event_desc, bool* has_sustain);
+	static FMOD_RESULT h_FMOD_Studio_EventDescription_getParameterDescriptionByName(FMOD::Studio::EventDescription* event_desc, const char* name, FMOD_STUDIO_PARAMETER_DESCRIPTION* parameter);
 
 	//FMOD STUDIO SYSTEM HOOKS
 
@@ -162,6 +307,11 @@ public:
 	static FMOD_RESULT h_FMOD_Studio_System_lookupID(FMOD::Studio::System* system, const char* path, FMOD_GUID* id);
 	static FMOD_RESULT h_FMOD_Studio_System_getEventByID(FMOD::Studio::System* system, const FMOD_GUID* id, FMOD::Studio::EventDescription** event_id);
 
+	inline static FStudioSystem::Update o_FMOD_Studio_System_update = nullptr;
+
+	//Called once per frame by the game
+	static FMOD_RESULT h_FMOD_Studio_System_update(FMOD::Studio::System* system);
+
 	static void UpdateReverbProperties();
 
 	static void Hook();
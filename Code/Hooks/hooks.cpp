@@ -2,124 +2,52 @@
 
 #include "fmod_hooks.hpp"
 
+#include "Audio/SoundLoadQueue.hpp"
+#include "Audio/SoundConfigLoader.hpp"
+#include "Audio/SoundMixer.hpp"
+
 #include <SmSdk/DirectoryManager.hpp>
 #include <SmSdk/AudioManager.hpp>
 
 #include "Utils/Console.hpp"
 #include "Utils/String.hpp"
-#include "Utils/File.hpp"
-#include "Utils/Json.hpp"
 
 #include "offsets.hpp"
 
 #include <MinHook.h>
 
-void replace_content_key_data(std::string& path, const std::string_view& keyRepl)
+void load_sound_config(const std::string_view& key, const std::string& keyRepl)
 {
-	if (path.empty() || path[0] != '$')
-		return;
-
-	const std::size_t v_slashIdx = path.find('/');
-	if (v_slashIdx == std::string::npos)
+	SoundConfigData v_config;
+	if (!SoundConfigLoader::Take(keyRepl, v_config))
 		return;
 
-	if (std::string_view(path).substr(0, v_slashIdx) != "$CONTENT_DATA")
-		return;
+	const std::uint32_t v_modBus = SoundMixer::GetModBus(keyRepl, key);
+	for (const SoundConfigBus& v_bus : v_config.buses)
+		SoundMixer::GetBus(v_modBus, v_bus.name, v_bus.volume);
 
-	path.replace(
-		path.begin(),
-		path.begin() + v_slashIdx,
-		keyRepl
-	);
-}
+	//Sounds from the bank take priority over the loose ones with the same name
+	if (!v_config.bankPath.empty())
+		SoundStorage::RegisterBank(v_config.bankPath, v_modBus);
 
-inline static std::unordered_map<std::string_view, int> g_reverbStringToIdx =
-{
-	{ "MOUNTAINS" , 0 },
-	{ "CAVE"      , 1 },
-	{ "GENERIC"   , 2 },
-	{ "UNDERWATER", 3 }
-};
-
-int getReverbSetting(const simdjson::dom::document_stream::iterator::value_type& reverbData)
-{
-	if (!reverbData.is_string()) return -1;
-
-	auto v_iter = g_reverbStringToIdx.find(reverbData.get_string());
-	if (v_iter == g_reverbStringToIdx.end())
+	for (const SoundConfigEntry& v_entry : v_config.sounds)
 	{
-		DebugErrorL("Invalid reverb preset name: ", reverbData.get_string().value_unsafe());
-		return -1;
+		std::uint32_t v_busId = v_modBus;
+		if (!v_entry.bus.empty())
+		{
+			v_busId = SoundMixer::FindBus(v_modBus, v_entry.bus);
+			if (v_busId == SoundMixer::InvalidBus)
+			{
+				DebugErrorL("The sound ", v_entry.name, " uses an undeclared bus: ", v_entry.bus);
+				v_busId = v_modBus;
+			}
+		}
+
+		SoundStorage::RegisterSound(v_entry.path, v_entry.name, v_entry.effectData, v_entry.loadPolicy, v_busId);
 	}
 
-	return v_iter->second;
-}
-
-void load_min_max_distance(const simdjson::dom::element& curSound, SoundEffectData& effectData)
-{
-	const auto v_minDistance = curSound["min_distance"];
-	const auto v_maxDistance = curSound["max_distance"];
-
-	effectData.fMinDistance = v_minDistance.is_number() ? JsonReader::GetNumber<float>(v_minDistance) : 0.0f;
-	effectData.fMaxDistance = v_maxDistance.is_number() ? JsonReader::GetNumber<float>(v_maxDistance) : 10000.0f;
-}
-
-void load_effect_data(const simdjson::dom::element& curSound, SoundEffectData& effectData)
-{
-	const auto v_soundIs3dNode = curSound["is3D"];
-	const auto v_reverbNode = curSound["reverb"];
-
-	effectData.is3D = v_soundIs3dNode.is_bool() ? v_soundIs3dNode.get_bool().value() : false;
-	effectData.reverbIdx = getReverbSetting(v_reverbNode);
-
-	load_min_max_distance(curSound, effectData);
-}
-
-void load_sound_config(const std::string& keyRepl)
-{
-	std::string v_configPath = keyRepl + "/sm_cae_config.json";
-	if (!File::Exists(v_configPath))
-	{
-		v_configPath = keyRepl + "/sm_dlm_config.json";
-		if (!File::Exists(v_configPath))
-			return;
-
-		DebugWarningL(keyRepl, " is using a legacy version of CustomAudioExtension config");
-	}
-
-	simdjson::dom::document v_document;
-	if (!JsonReader::LoadParseSimdjsonCommentsC(
-		String::ToWide(v_configPath),
-		v_document,
-		simdjson::dom::element_type::OBJECT))
-	{
-		DebugErrorL("Couldn't load the CAE sound config file: ", v_configPath);
-		return;
-	}
-
-	const auto v_soundList = v_document.root()["soundList"];
-	if (!v_soundList.is_object())
-	{
-		DebugErrorL("No sound list: ", v_configPath);
-		return;
-	}
-
-	SoundEffectData v_effectData;
-
-	for (auto& v_soundListObj : v_soundList.get_object())
-	{
-		if (!v_soundListObj.value.is_object()) continue;
-
-		const auto v_soundPathNode = v_soundListObj.value["path"];
-		if (!v_soundPathNode.is_string()) continue;
-
-		load_effect_data(v_soundListObj.value, v_effectData);
-
-		std::string v_soundPath(v_soundPathNode.get_string().value().data());
-		replace_content_key_data(v_soundPath, keyRepl);
-
-		SoundStorage::PreloadSound(v_soundPath, v_soundListObj.key, v_effectData);
-	}
+	//Start the first loads while the rest of the world is loading
+	SoundLoadQueue::Update();
 }
 
 bool separate_key(const std::string_view& path, std::string_view& outKey)
@@ -147,7 +75,7 @@ void preload_sounds(const std::string& shapeSetPath)
 		return;
 	}
 
-	load_sound_config(std::string(v_replacement));
+	load_sound_config(v_key, std::string(v_replacement));
 }
 
 void Hooks::h_LoadShapesetsFunction(void* shape_manager, const std::string& shape_set, int some_flag)
@@ -158,9 +86,10 @@ void Hooks::h_LoadShapesetsFunction(void* shape_manager, const std::string& shap
 
 void Hooks::h_InitShapeManager(const char* file_data, unsigned int file_line)
 {
-	DebugOutL(__FUNCTION__, " -> Clearing sounds!");
+	DebugOutL(__FUNCTION__, " -> Reloading sounds!");
 
-	SoundStorage::ClearSounds();
+	SoundConfigLoader::Reset();
+	SoundStorage::BeginReload();
 	FMODHooks::UpdateReverbProperties();
 
 	return Hooks::o_InitShapeManager(file_data, file_line);
@@ -154,9 +154,11 @@ namespace Engine
 		friend class Console;
 
 	public:
+		//The whole message is written under the lock, so messages and colors from other threads don't interleave
 		template<typename ...ArgList>
 		inline void operator()(const ArgList& ...arg_list)
 		{
+			std::lock_guard v_lock(m_outputMutex);
 			this->variadic_func(arg_list...);
 		}
 
@@ -180,6 +182,8 @@ namespace Engine
 
 		__ConsoleOutputHandler()  = default;
 		~__ConsoleOutputHandler() = default;
+
+		std::mutex m_outputMutex;
 	};
 }
 
@@ -4,8 +4,37 @@
 #include <fstream>
 #include <string>
 
+#include <cstdint>
+
 namespace File
 {
+	struct Stamp
+	{
+		std::uintmax_t size = 0;
+		std::int64_t writeTime = 0;
+
+		inline bool operator==(const Stamp& other) const noexcept
+		{
+			return size == other.size && writeTime == other.writeTime;
+		}
+	};
+
+	inline bool GetStamp(const std::string& path, Stamp& r_stamp)
+	{
+		namespace fs = std::filesystem;
+
+		std::error_code v_ec;
+		const std::uintmax_t v_size = fs::file_size(path, v_ec);
+		if (v_ec) return false;
+
+		const fs::file_time_type v_writeTime = fs::last_write_time(path, v_ec);
+		if (v_ec) return false;
+
+		r_stamp.size = v_size;
+		r_stamp.writeTime = static_cast<std::int64_t>(v_writeTime.time_since_epoch().count());
+		return true;
+	}
+
 	inline bool Exists(const std::string& path)
 	{
 		namespace fs = std::filesystem;
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+
+#include <cstdint>
+#include <cstddef>
+
+//Open addressing hash -> index table with linear probing
+//Stores only the precomputed hash and a 32 bit index into an external contiguous array
+class FlatHashIndex
+{
+public:
+	static constexpr std::uint32_t InvalidValue = 0xFFFFFFFF;
+
+	inline void clear() noexcept
+	{
+		m_slots.clear();
+		m_size = 0;
+		m_shift = 64;
+	}
+
+	inline std::size_t size() const noexcept
+	{
+		return m_size;
+	}
+
+	inline void reserve(const std::size_t count)
+	{
+		std::size_t v_capacity = 16;
+		while (v_capacity * 3 < count * 4)
+			v_capacity <<= 1;
+
+		if (v_capacity > m_slots.size())
+			this->rehash(v_capacity);
+	}
+
+	inline std::uint32_t find(const std::size_t hash) const noexcept
+	{
+		if (m_slots.empty()) return InvalidValue;
+
+		const std::size_t v_mask = m_slots.size() - 1;
+		for (std::size_t a = this->slotIndex(hash);; a = (a + 1) & v_mask)
+		{
+			const Slot& v_slot = m_slots[a];
+			if (v_slot.value == InvalidValue || v_slot.hash == hash)
+				return v_slot.value;
+		}
+	}
+
+	//Returns false if the hash is already present in the table
+	inline bool insert(const std::size_t hash, const std::uint32_t value)
+	{
+		if ((m_size + 1) * 4 > m_slots.size() * 3)
+			this->rehash(m_slots.empty() ? 16 : m_slots.size() * 2);
+
+		const std::size_t v_mask = m_slots.size() - 1;
+		for (std::size_t a = this->slotIndex(hash);; a = (a + 1) & v_mask)
+		{
+			Slot& v_slot = m_slots[a];
+			if (v_slot.value == InvalidValue)
+			{
+				v_slot.hash = hash;
+				v_slot.value = value;
+				m_size++;
+
+				return true;
+			}
+
+			if (v_slot.hash == hash)
+				return false;
+		}
+	}
+
+private:
+	struct Slot
+	{
+		std::size_t hash;
+		std::uint32_t value;
+	};
+
+	//Fibonacci hashing, spreads the low quality bits of std::hash over the whole table
+	inline std::size_t slotIndex(const std::size_t hash) const noexcept
+	{
+		return static_cast<std::size_t>((static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> m_shift);
+	}
+
+	inline void rehash(const std::size_t capacity)
+	{
+		std::vector<Slot> v_oldSlots(capacity, Slot{ 0, InvalidValue });
+		v_oldSlots.swap(m_slots);
+
+		m_shift = 64;
+		for (std::size_t a = capacity; a > 1; a >>= 1)
+			m_shift--;
+
+		const std::size_t v_mask = capacity - 1;
+		for (const Slot& v_oldSlot : v_oldSlots)
+		{
+			if (v_oldSlot.value == InvalidValue) continue;
+
+			std::size_t v_idx = this->slotIndex(v_oldSlot.hash);
+			while (m_slots[v_idx].value != InvalidValue)
+				v_idx = (v_idx + 1) & v_mask;
+
+			m_slots[v_idx] = v_oldSlot;
+		}
+	}
+
+	std::vector<Slot> m_slots;
+	std::size_t m_size = 0;
+	unsigned int m_shift = 64;
+};
\ No newline at end of file
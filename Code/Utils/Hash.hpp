@@ -0,0 +1,169 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace Hash
+{
+	//Streaming XXH64 implementation
+	class XXH64
+	{
+	public:
+		inline XXH64(const std::uint64_t seed = 0) noexcept
+		{
+			m_acc[0] = seed + Prime1 + Prime2;
+			m_acc[1] = seed + Prime2;
+			m_acc[2] = seed;
+			m_acc[3] = seed - Prime1;
+			m_seed = seed;
+		}
+
+		inline void update(const void* data, std::size_t size) noexcept
+		{
+			const std::uint8_t* v_pData = static_cast<const std::uint8_t*>(data);
+			m_totalLength += size;
+
+			if (m_bufferSize + size < 32)
+			{
+				std::memcpy(m_buffer + m_bufferSize, v_pData, size);
+				m_bufferSize += size;
+				return;
+			}
+
+			if (m_bufferSize)
+			{
+				const std::size_t v_fillSize = 32 - m_bufferSize;
+				std::memcpy(m_buffer + m_bufferSize, v_pData, v_fillSize);
+				this->consumeStripe(m_buffer);
+
+				v_pData += v_fillSize;
+				size -= v_fillSize;
+				m_bufferSize = 0;
+			}
+
+			for (; size >= 32; v_pData += 32, size -= 32)
+				this->consumeStripe(v_pData);
+
+			std::memcpy(m_buffer, v_pData, size);
+			m_bufferSize = size;
+		}
+
+		inline std::uint64_t digest() const noexcept
+		{
+			std::uint64_t v_hash;
+			if (m_totalLength >= 32)
+			{
+				v_hash = Rotl(m_acc[0], 1) + Rotl(m_acc[1], 7) + Rotl(m_acc[2], 12) + Rotl(m_acc[3], 18);
+				for (const std::uint64_t v_acc : m_acc)
+					v_hash = (v_hash ^ Round(0, v_acc)) * Prime1 + Prime4;
+			}
+			else
+			{
+				v_hash = m_seed + Prime5;
+			}
+
+			v_hash += m_totalLength;
+
+			const std::uint8_t* v_pData = m_buffer;
+			std::size_t v_remaining = m_bufferSize;
+
+			for (; v_remaining >= 8; v_pData += 8, v_remaining -= 8)
+				v_hash = Rotl(v_hash ^ Round(0, Read64(v_pData)), 27) * Prime1 + Prime4;
+
+			if (v_remaining >= 4)
+			{
+				v_hash = Rotl(v_hash ^ (Read32(v_pData) * Prime1), 23) * Prime2 + Prime3;
+				v_pData += 4;
+				v_remaining -= 4;
+			}
+
+			for (; v_remaining > 0; v_pData++, v_remaining--)
+				v_hash = Rotl(v_hash ^ (*v_pData * Prime5), 11) * Prime1;
+
+			v_hash ^= v_hash >> 33;
+			v_hash *= Prime2;
+			v_hash ^= v_hash >> 29;
+			v_hash *= Prime3;
+			v_hash ^= v_hash >> 32;
+
+			return v_hash;
+		}
+
+	private:
+		static constexpr std::uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+		static constexpr std::uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+		static constexpr std::uint64_t Prime3 = 0x165667B19E3779F9ull;
+		static constexpr std::uint64_t Prime4 = 0x85EBCA77C2B2AE63ull;
+		static constexpr std::uint64_t Prime5 = 0x27D4EB2F165667C5ull;
+
+		inline static std::uint64_t Rotl(const std::uint64_t value, const int bits) noexcept
+		{
+			return (value << bits) | (value >> (64 - bits));
+		}
+
+		inline static std::uint64_t Round(std::uint64_t acc, const std::uint64_t input) noexcept
+		{
+			acc += input * Prime2;
+			return Rotl(acc, 31) * Prime1;
+		}
+
+		inline static std::uint64_t Read64(const std::uint8_t* data) noexcept
+		{
+			std::uint64_t v_value;
+			std::memcpy(&v_value, data, sizeof(v_value));
+			return v_value;
+		}
+
+		inline static std::uint64_t Read32(const std::uint8_t* data) noexcept
+		{
+			std::uint32_t v_value;
+			std::memcpy(&v_value, data, sizeof(v_value));
+			return v_value;
+		}
+
+		inline void consumeStripe(const std::uint8_t* data) noexcept
+		{
+			for (std::size_t a = 0; a < 4; a++)
+				m_acc[a] = Round(m_acc[a], Read64(data + a * 8));
+		}
+
+		std::uint64_t m_acc[4];
+		std::uint64_t m_seed;
+		std::uint64_t m_totalLength = 0;
+
+		std::uint8_t m_buffer[32];
+		std::size_t m_bufferSize = 0;
+	};
+
+	inline std::uint64_t Data(const void* data, const std::size_t size, const std::uint64_t seed = 0) noexcept
+	{
+		XXH64 v_state(seed);
+		v_state.update(data, size);
+
+		return v_state.digest();
+	}
+
+	//Hashes the whole file in chunks without loading it into memory
+	inline bool File(const std::filesystem::path& path, std::uint64_t& r_hash)
+	{
+		std::ifstream v_input_file(path, std::ios::binary);
+		if (!v_input_file.is_open()) return false;
+
+		XXH64 v_state;
+		char v_buffer[64 * 1024];
+
+		while (v_input_file)
+		{
+			v_input_file.read(v_buffer, sizeof(v_buffer));
+			v_state.update(v_buffer, static_cast<std::size_t>(v_input_file.gcount()));
+		}
+
+		r_hash = v_state.digest();
+		return true;
+	}
+}
\ No newline at end of file
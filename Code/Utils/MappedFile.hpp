@@ -0,0 +1,102 @@
+#pragma once
+
+#include <SmSdk/win_include.hpp>
+
+#include <utility>
+#include <string>
+
+#include <cstdint>
+#include <cstddef>
+
+//Read only memory mapped file, the pages are shared with the OS file cache
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile&) = delete;
+
+	inline MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	inline MappedFile& operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			this->close();
+
+			m_pData = other.m_pData;
+			m_size = other.m_size;
+
+			other.m_pData = nullptr;
+			other.m_size = 0;
+		}
+
+		return *this;
+	}
+
+	inline ~MappedFile()
+	{
+		this->close();
+	}
+
+	inline bool open(const std::wstring& path)
+	{
+		this->close();
+
+		//Other processes can still open the file, but writes into it show up in the mapping. Replacing or deleting
+		//the file fails until the mapping is closed, so writers have to handle that
+		const HANDLE v_hFile = CreateFileW(
+			path.c_str(),
+			GENERIC_READ,
+			FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			NULL,
+			OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL,
+			NULL
+		);
+
+		if (v_hFile == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER v_fileSize;
+		if (!GetFileSizeEx(v_hFile, &v_fileSize) || v_fileSize.QuadPart == 0)
+		{
+			CloseHandle(v_hFile);
+			return false;
+		}
+
+		const HANDLE v_hMapping = CreateFileMappingW(v_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		CloseHandle(v_hFile);
+
+		if (!v_hMapping)
+			return false;
+
+		m_pData = static_cast<const std::uint8_t*>(MapViewOfFile(v_hMapping, FILE_MAP_READ, 0, 0, 0));
+		CloseHandle(v_hMapping);
+
+		if (!m_pData)
+			return false;
+
+		m_size = static_cast<std::size_t>(v_fileSize.QuadPart);
+		return true;
+	}
+
+	inline void close() noexcept
+	{
+		if (!m_pData) return;
+
+		UnmapViewOfFile(m_pData);
+		m_pData = nullptr;
+		m_size = 0;
+	}
+
+	inline bool isOpen() const noexcept { return m_pData != nullptr; }
+	inline const std::uint8_t* data() const noexcept { return m_pData; }
+	inline std::size_t size() const noexcept { return m_size; }
+
+private:
+	const std::uint8_t* m_pData = nullptr;
+	std::size_t m_size = 0;
+};
\ No newline at end of file
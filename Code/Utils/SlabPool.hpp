@@ -0,0 +1,164 @@
+#pragma once
+
+#include <utility>
+#include <memory>
+#include <vector>
+#include <new>
+
+#include <cstdint>
+#include <cstddef>
+
+//Fixed size object pool that hands out handles instead of pointers.
+//Handle layout: bit 63 is always set, bits 32-62 hold the generation of the slot and bits 0-31 hold the slot index.
+//A freed slot bumps its generation, so stale and double released handles are rejected without touching the object
+template<typename T, std::size_t SlabSize = 256>
+class SlabPool
+{
+public:
+	static constexpr std::uint64_t HandleFlag = 1ULL << 63;
+	static constexpr std::uint64_t InvalidHandle = 0;
+
+	SlabPool() = default;
+	SlabPool(const SlabPool&) = delete;
+	SlabPool(SlabPool&&) = delete;
+
+	inline ~SlabPool()
+	{
+		for (std::size_t a = 0; a < m_slotCount; a++)
+		{
+			Slot& v_slot = this->slot(static_cast<std::uint32_t>(a));
+			if (v_slot.alive)
+				v_slot.object()->~T();
+		}
+	}
+
+	inline static bool IsHandle(const std::uint64_t handle) noexcept
+	{
+		return (handle & HandleFlag) != 0;
+	}
+
+	//Constructs a new object in a free slot, a new slab is only allocated when every slot is in use
+	template<typename ...ArgList>
+	inline std::uint64_t create(T** r_pObject, ArgList&& ...arg_list)
+	{
+		if (m_freeHead == InvalidIndex)
+			this->grow();
+
+		const std::uint32_t v_idx = m_freeHead;
+		Slot& v_slot = this->slot(v_idx);
+
+		T* v_pObject = new (v_slot.storage) T(std::forward<ArgList>(arg_list)...);
+		m_freeHead = v_slot.nextFree;
+		v_slot.alive = true;
+		m_size++;
+
+		if (r_pObject)
+			*r_pObject = v_pObject;
+
+		return HandleFlag | (std::uint64_t(v_slot.generation) << 32) | v_idx;
+	}
+
+	//Returns nullptr if the handle is stale or doesn't belong to the pool
+	inline T* get(const std::uint64_t handle) const noexcept
+	{
+		if (!IsHandle(handle)) return nullptr;
+
+		const std::uint32_t v_idx = static_cast<std::uint32_t>(handle);
+		if (v_idx >= m_slotCount) return nullptr;
+
+		Slot& v_slot = const_cast<SlabPool*>(this)->slot(v_idx);
+		if (!v_slot.alive || v_slot.generation != GetGeneration(handle))
+			return nullptr;
+
+		return v_slot.object();
+	}
+
+	//Returns false if the handle was already destroyed
+	inline bool destroy(const std::uint64_t handle) noexcept
+	{
+		T* v_pObject = this->get(handle);
+		if (!v_pObject) return false;
+
+		const std::uint32_t v_idx = static_cast<std::uint32_t>(handle);
+		Slot& v_slot = this->slot(v_idx);
+
+		v_pObject->~T();
+		v_slot.alive = false;
+		v_slot.generation = NextGeneration(v_slot.generation);
+		v_slot.nextFree = m_freeHead;
+		m_freeHead = v_idx;
+		m_size--;
+
+		return true;
+	}
+
+	//Calls the function with every live object, the function must not create or destroy objects
+	template<typename Func>
+	inline void forEach(Func&& func)
+	{
+		for (std::size_t a = 0; a < m_slotCount; a++)
+		{
+			Slot& v_slot = this->slot(static_cast<std::uint32_t>(a));
+			if (v_slot.alive)
+				func(*v_slot.object());
+		}
+	}
+
+	inline std::size_t size() const noexcept { return m_size; }
+	inline std::size_t capacity() const noexcept { return m_slotCount; }
+
+private:
+	static constexpr std::uint32_t InvalidIndex = 0xFFFFFFFF;
+	static constexpr std::uint32_t GenerationMask = 0x7FFFFFFF;
+
+	struct Slot
+	{
+		alignas(T) unsigned char storage[sizeof(T)];
+		std::uint32_t generation;
+		std::uint32_t nextFree;
+		bool alive;
+
+		inline T* object() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+	};
+
+	inline static std::uint32_t GetGeneration(const std::uint64_t handle) noexcept
+	{
+		return static_cast<std::uint32_t>(handle >> 32) & GenerationMask;
+	}
+
+	//Generation 0 is skipped, so a handle with only the flag set is never valid
+	inline static std::uint32_t NextGeneration(const std::uint32_t generation) noexcept
+	{
+		const std::uint32_t v_next = (generation + 1) & GenerationMask;
+		return v_next ? v_next : 1;
+	}
+
+	inline Slot& slot(const std::uint32_t idx) noexcept
+	{
+		return m_slabs[idx / SlabSize][idx % SlabSize];
+	}
+
+	inline void grow()
+	{
+		//Slabs never move, so pointers to the objects stay valid until they are destroyed
+		std::unique_ptr<Slot[]> v_pSlab = std::make_unique<Slot[]>(SlabSize);
+
+		const std::uint32_t v_firstIdx = static_cast<std::uint32_t>(m_slotCount);
+		for (std::size_t a = 0; a < SlabSize; a++)
+		{
+			Slot& v_slot = v_pSlab[a];
+			v_slot.generation = 1;
+			v_slot.alive = false;
+			v_slot.nextFree = (a + 1 < SlabSize) ? static_cast<std::uint32_t>(v_firstIdx + a + 1) : InvalidIndex;
+		}
+
+		m_slabs.push_back(std::move(v_pSlab));
+		m_slotCount += SlabSize;
+		m_freeHead = v_firstIdx;
+	}
+
+	std::vector<std::unique_ptr<Slot[]>> m_slabs;
+	std::size_t m_slotCount = 0;
+	std::size_t m_size = 0;
+	std::uint32_t m_freeHead = InvalidIndex;
+};
\ No newline at end of file
@@ -1,12 +1,16 @@
 #include <SmSdk/TimestampCheck.hpp>
 #include <SmSdk/win_include.hpp>
 
+#include "Audio/AudioSettings.hpp"
+#include "Audio/PcmCache.hpp"
 #include "Hooks/fmod_hooks.hpp"
 #include "Hooks/hooks.hpp"
 #include "Utils/Console.hpp"
 
 #include <MinHook.h>
 
+#include <filesystem>
+
 #pragma comment(lib, "User32.lib")
 
 void dll_initialize()
@@ -37,7 +41,20 @@ void dll_entry_func(HMODULE module)
 static bool g_mhInitialized = false;
 static bool g_mhAttached = false;
 
-void dll_attach()
+void load_settings(HMODULE module)
+{
+	wchar_t v_modulePath[MAX_PATH];
+	const DWORD v_pathLength = GetModuleFileNameW(module, v_modulePath, MAX_PATH);
+	if (v_pathLength == 0 || v_pathLength == MAX_PATH)
+		return;
+
+	AudioSettings::Load(std::filesystem::path(v_modulePath).parent_path().wstring());
+
+	if (!AudioSettings::PcmCacheDirectory.empty())
+		PcmCache::Initialize(AudioSettings::PcmCacheDirectory, AudioSettings::PcmCacheSizeLimit);
+}
+
+void dll_attach(HMODULE module)
 {
 	if (!SmSdk::CheckTimestamp(_SM_TIMESTAMP_073_776))
 	{
@@ -49,6 +66,8 @@ void dll_attach()
 		return;
 	}
 
+	load_settings(module);
+
 	if (MH_Initialize() == MH_OK)
 	{
 		g_mhInitialized = true;
@@ -78,7 +97,7 @@ BOOL APIENTRY DllMain(HANDLE hModule, DWORD ul_reason_for_call, LPVOID lpReserve
 	{
 	case DLL_PROCESS_ATTACH:
 		//CreateThread(NULL, NULL, (LPTHREAD_START_ROUTINE)dll_entry_func, hModule, NULL, NULL);
-		dll_attach();
+		dll_attach(static_cast<HMODULE>(hModule));
 		break;
 	case DLL_PROCESS_DETACH:
 		dll_detach();